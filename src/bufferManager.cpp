@@ -3,94 +3,582 @@
 BufferManager::BufferManager()
 {
     logger.log("BufferManager::BufferManager");
+    this->buildShards(1);
+}
+
+BufferManager::~BufferManager()
+{
+    {
+        lock_guard<mutex> lock(this->prefetchMutex);
+        this->stopPrefetching = true;
+    }
+    this->prefetchQueued.notify_all();
+    if (this->prefetchThread.joinable())
+        this->prefetchThread.join();
+    this->logStatistics();
+}
+
+/**
+ * @brief Number of shards a pool of BLOCK_COUNT blocks is split into. Every
+ * shard is given at least MIN_BLOCKS_PER_SHARD blocks so the policy of each
+ * shard still sees enough pages to tell hot ones from cold ones.
+ *
+ * @return int 
+ */
+static int getShardCount()
+{
+    return min<int>(BufferManager::MAX_SHARD_COUNT, max<int>(1, BLOCK_COUNT / BufferManager::MIN_BLOCKS_PER_SHARD));
+}
+
+/**
+ * @brief Replaces the shards of the pool by shardCount empty ones using the
+ * current replacement strategy, writing dirty pages back first. Outstanding
+ * prefetches are dropped. Must not be called while any frame is pinned.
+ *
+ * @param shardCount 
+ */
+void BufferManager::buildShards(int shardCount)
+{
+    logger.log("BufferManager::buildShards");
+    unique_lock<mutex> prefetchLock(this->prefetchMutex);
+    this->prefetchQueue.clear();
+    this->prefetchPending.clear();
+    if (!(this->prefetchInFlight == PageId{"", -1}))
+        this->prefetchInFlightCancelled = true;
+    for (auto &shard : this->shards)
+    {
+        lock_guard<mutex> lock(shard->shardMutex);
+        for (Frame &frame : shard->frames)
+            if (frame.occupied && frame.dirty)
+                this->flushFrame(frame);
+    }
+    this->shards.clear();
+    for (int shardIndex = 0; shardIndex < shardCount; shardIndex++)
+    {
+        this->shards.emplace_back(new PoolShard());
+        PoolShard &shard = *this->shards.back();
+        shard.shardIndex = shardIndex;
+        shard.policy = createReplacementPolicy(this->strategy);
+        shard.policy->setCapacity(max<int>(1, BLOCK_COUNT / shardCount));
+        shard.byteBudget = max<size_t>(1, BUFFER_BYTES / shardCount);
+    }
+}
+
+/**
+ * @brief The shard a page lives in.
+ *
+ * @param pageId 
+ * @return PoolShard& 
+ */
+PoolShard &BufferManager::shardFor(const PageId &pageId)
+{
+    return *this->shards[PageIdHash()(pageId) % this->shards.size()];
+}
+
+/**
+ * @brief Replaces the policy used to pick victims. The pool is written back
+ * and emptied so the new policy starts with a consistent view of the frames
+ * and the counters are reset so they reflect the new policy only.
+ *
+ * @param strategy 
+ */
+void BufferManager::setReplacementPolicy(ReplacementStrategy strategy)
+{
+    logger.log("BufferManager::setReplacementPolicy");
+    this->strategy = strategy;
+    this->buildShards(this->shards.size());
+    this->hitCount = 0;
+    this->missCount = 0;
+    this->evictionCount = 0;
+    this->prefetchCount = 0;
+    this->writeBackCount = 0;
+}
+
+string BufferManager::getReplacementPolicyName()
+{
+    return this->shards.front()->policy->name();
+}
+
+/**
+ * @brief Sets the memory budget of the pool. BLOCK_COUNT is derived from the
+ * budget as the number of pages of BLOCK_SIZE it can hold. If the new block
+ * count calls for a different number of shards and no frame is pinned the
+ * pool is rebuilt, otherwise every shard keeps its pages and unpinned pages
+ * are evicted until each fits into its share of the new budget.
+ *
+ * @param byteCount 
+ */
+void BufferManager::setBufferBytes(size_t byteCount)
+{
+    logger.log("BufferManager::setBufferBytes");
+    BUFFER_BYTES = byteCount;
+    BLOCK_COUNT = max<size_t>(1, byteCount / (size_t)(BLOCK_SIZE * 1000));
+    int shardCount = getShardCount();
+    if (shardCount != (int)this->shards.size() && this->pinnedBytes == 0)
+    {
+        this->buildShards(shardCount);
+        return;
+    }
+    for (auto &shard : this->shards)
+    {
+        lock_guard<mutex> lock(shard->shardMutex);
+        shard->byteBudget = max<size_t>(1, BUFFER_BYTES / this->shards.size());
+        shard->policy->setCapacity(max<int>(1, BLOCK_COUNT / this->shards.size()));
+        this->trimShard(*shard);
+    }
+}
+
+/**
+ * @brief Evicts unpinned pages until the shard fits into its budget.
+ *
+ * @param shard 
+ */
+void BufferManager::trimShard(PoolShard &shard)
+{
+    auto isEvictable = [&shard](int frameIndex) {
+        return shard.frames[frameIndex].pinCount == 0;
+    };
+    while (shard.poolBytes > shard.byteBudget)
+    {
+        int victim = shard.policy->pickVictim(isEvictable);
+        if (victim == -1)
+            break;
+        ioStatistics.recordEviction(shard.frames[victim].pageId.tableName);
+        this->evictFrame(shard, victim);
+        this->evictionCount++;
+    }
+}
+
+/**
+ * @brief Memory a page of the given dimensions takes up in the pool.
+ *
+ * @param rowCount 
+ * @param columnCount 
+ * @return size_t 
+ */
+static size_t getPageByteCount(int rowCount, int columnCount)
+{
+    return (size_t)rowCount * columnCount * sizeof(int);
 }
 
 /**
  * @brief Function called to read a page from the buffer manager. If the page is
- * not present in the pool, the page is read and then inserted into the pool.
+ * not present in the pool, a frame is reserved for it and the page is read
+ * into it without holding the shard's lock; readers asking for the same page
+ * meanwhile wait for that read. The frame holding the page stays pinned until
+ * the returned handle and all its copies are released. If the page is being
+ * prefetched at the moment the call waits for that read to finish instead of
+ * reading the page again. The table is passed in by the caller, the pool
+ * never looks tables up in the catalogue so it can be used from worker
+ * threads while statements run.
  *
- * @param tableName 
+ * @param table 
  * @param pageIndex 
- * @return Page 
+ * @param streamId identifies the cursor reading the page so sequential scans
+ * can be recognised, -1 if the access is not part of a scan
+ * @return PageHandle 
  */ 
-Page BufferManager::getPage(string tableName, int pageIndex)
+PageHandle BufferManager::pinPage(Table *table, int pageIndex, int streamId)
 {
-    logger.log("BufferManager::getPage");
-    string pageName = "../data/temp/"+tableName + "_Page" + to_string(pageIndex);
-    
-    if (this->inPool(pageName))
-        return this->getFromPool(pageName);
+    logger.log("BufferManager::pinPage");
+    string tableName = table->tableName;
+    PageId pageId = {tableName, pageIndex};
+    this->discardPrefetch(pageId);
+    PoolShard &shard = this->shardFor(pageId);
+    unique_lock<mutex> lock(shard.shardMutex);
+    Frame *frame = nullptr;
+    int frameIndex = this->frameFor(shard, pageId);
+    bool hit = frameIndex != -1;
+    if (hit)
+    {
+        frame = &shard.frames[frameIndex];
+        this->pinFrame(frame);
+        // the first pin of a page read ahead is the read it was
+        // prefetched for, not a re-reference
+        if (frame->prefetched)
+            frame->prefetched = false;
+        else
+            shard.policy->recordAccess(frameIndex);
+        shard.frameLoaded.wait(lock, [frame] { return !frame->loading; });
+    }
+    else
+    {
+        int rowCount = table->rowsPerBlockCount[pageIndex];
+        int columnCount = table->columnCount;
+        frame = this->placePage(shard, pageId, getPageByteCount(rowCount, columnCount), true);
+        frame->loading = true;
+        this->pinFrame(frame);
+        lock.unlock();
+        Page page(tableName, pageIndex, rowCount, columnCount);
+        lock.lock();
+        frame->page = move(page);
+        frame->loading = false;
+        shard.frameLoaded.notify_all();
+    }
+    lock.unlock();
+
+    if (hit)
+        this->hitCount++;
     else
-        return this->insertIntoPool(tableName, pageIndex);
+        this->missCount++;
+    ioStatistics.recordPageRequest(tableName, hit);
+    if (streamId != -1)
+        this->schedulePrefetch(streamId, table, pageId);
+    return PageHandle(frame);
 }
 
 /**
- * @brief Checks to see if a page exists in the pool
+ * @brief Places a pin on a frame. The caller holds the lock of the frame's
+ * shard. The pinned bytes of the whole pool are tracked so the prefetch
+ * thread knows how much of the budget it may use.
  *
- * @param pageName 
- * @return true 
- * @return false 
+ * @param frame 
  */
-bool BufferManager::inPool(string pageName)
+void BufferManager::pinFrame(Frame *frame)
 {
-    logger.log("BufferManager::inPool");
-    for (auto page : this->pages)
+    if (frame->pinCount++ == 0)
+        this->pinnedBytes += frame->byteCount;
+}
+
+/**
+ * @brief Called when the last handle on a frame goes away. A frame whose page
+ * was deleted while it was pinned is only recycled at this point.
+ *
+ * @param frame 
+ */
+void BufferManager::unpinFrame(Frame *frame)
+{
+    PoolShard &shard = *this->shards[frame->shardIndex];
+    lock_guard<mutex> lock(shard.shardMutex);
+    if (--frame->pinCount != 0)
+        return;
+    this->pinnedBytes -= frame->byteCount;
+    if (!frame->occupied)
     {
-        if (pageName == page.pageName)
-            return true;
+        frame->page = Page();
+        shard.freeFrames.push_back(frame->frameIndex);
     }
-    return false;
 }
 
 /**
- * @brief If the page is present in the pool, then this function returns the
- * page. Note that this function will fail if the page is not present in the
- * pool.
+ * @brief Looks the page up in the shard's page table.
  *
- * @param pageName 
- * @return Page 
+ * @param shard 
+ * @param pageId 
+ * @return int index of the frame holding the page, -1 if it is not in the pool
  */
-Page BufferManager::getFromPool(string pageName)
+int BufferManager::frameFor(PoolShard &shard, const PageId &pageId)
 {
-    logger.log("BufferManager::getFromPool");
-    for (auto page : this->pages)
-        if (pageName == page.pageName)
-            return page;
+    auto entry = shard.pageTable.find(pageId);
+    if (entry == shard.pageTable.end())
+        return -1;
+    return entry->second;
 }
 
 /**
- * @brief Inserts page indicated by tableName and pageIndex into pool. If the
- * pool is full, the pool ejects the oldest inserted page from the pool and adds
- * the current page at the end. It naturally follows a queue data structure. 
+ * @brief Finds a frame of the shard for a new page of byteCount bytes. While
+ * the page does not fit into what is left of the shard's budget the
+ * replacement policy names unpinned frames to evict. If every frame is pinned
+ * the shard grows past its budget instead, unless mayGrow is false. A page
+ * larger than the whole budget is still given a frame once everything else
+ * has been evicted.
  *
- * @param tableName 
- * @param pageIndex 
- * @return Page 
+ * @param shard 
+ * @param byteCount 
+ * @param mayGrow 
+ * @return int index of an empty frame, -1 if none could be found without
+ * growing the pool
  */
-Page BufferManager::insertIntoPool(string tableName, int pageIndex)
+int BufferManager::allocateFrame(PoolShard &shard, size_t byteCount, bool mayGrow)
 {
-    logger.log("BufferManager::insertIntoPool");
-    Page page(tableName, pageIndex);
-    if (this->pages.size() >= BLOCK_COUNT)
-        pages.pop_front();
-    pages.push_back(page);
-    return page;
+    logger.log("BufferManager::allocateFrame");
+    auto isEvictable = [&shard](int frameIndex) {
+        return shard.frames[frameIndex].pinCount == 0;
+    };
+    while (!shard.pageTable.empty() && shard.poolBytes + byteCount > shard.byteBudget)
+    {
+        int victim = shard.policy->pickVictim(isEvictable);
+        if (victim == -1)
+        {
+            logger.log("BufferManager::allocateFrame: all frames pinned");
+            if (!mayGrow)
+                return -1;
+            break;
+        }
+        ioStatistics.recordEviction(shard.frames[victim].pageId.tableName);
+        this->evictFrame(shard, victim);
+        this->evictionCount++;
+    }
+    if (!shard.freeFrames.empty())
+    {
+        int frameIndex = shard.freeFrames.back();
+        shard.freeFrames.pop_back();
+        return frameIndex;
+    }
+    shard.frames.emplace_back();
+    shard.frames.back().frameIndex = shard.frames.size() - 1;
+    shard.frames.back().shardIndex = shard.shardIndex;
+    return shard.frames.size() - 1;
+}
+
+/**
+ * @brief Gives the page a frame of its shard and enters it into the shard's
+ * page table and policy. The caller holds the shard's lock and fills in the
+ * page itself.
+ *
+ * @param shard 
+ * @param pageId 
+ * @param byteCount 
+ * @param mayGrow 
+ * @return Frame* the frame, nullptr if mayGrow is false and no frame could
+ * be had within the budget
+ */
+Frame *BufferManager::placePage(PoolShard &shard, const PageId &pageId, size_t byteCount, bool mayGrow)
+{
+    int frameIndex = this->allocateFrame(shard, byteCount, mayGrow);
+    if (frameIndex == -1)
+        return nullptr;
+    Frame &frame = shard.frames[frameIndex];
+    frame.pageId = pageId;
+    frame.byteCount = byteCount;
+    shard.poolBytes += byteCount;
+    frame.occupied = true;
+    frame.loading = false;
+    frame.prefetched = false;
+    frame.dirty = false;
+    shard.pageTable[pageId] = frameIndex;
+    shard.policy->recordInsert(frameIndex, pageId);
+    return &frame;
+}
+
+/**
+ * @brief Removes the page held in the frame from the pool. An unpinned frame
+ * is marked as free right away, a pinned one once its last handle is released.
+ * A dirty page is written to disk first unless writeBack is false, which is
+ * the case when the page itself is being deleted.
+ *
+ * @param shard 
+ * @param frameIndex 
+ * @param writeBack 
+ */
+void BufferManager::evictFrame(PoolShard &shard, int frameIndex, bool writeBack)
+{
+    logger.log("BufferManager::evictFrame");
+    Frame &frame = shard.frames[frameIndex];
+    if (frame.dirty && writeBack)
+        this->flushFrame(frame);
+    frame.dirty = false;
+    shard.pageTable.erase(frame.pageId);
+    shard.policy->recordRemoval(frameIndex);
+    shard.poolBytes -= frame.byteCount;
+    frame.occupied = false;
+    if (frame.pinCount == 0)
+    {
+        frame.page = Page();
+        shard.freeFrames.push_back(frameIndex);
+    }
+}
+
+/**
+ * @brief Notes the page a stream has just pinned. If it directly follows the
+ * page the stream pinned before, the following pages of the table that are
+ * not yet in the pool are queued for the prefetch thread. At most
+ * PREFETCH_DEPTH pages are queued ahead of the stream, and never more than
+ * fit into BUFFER_BYTES once the pinned pages and earlier prefetches are
+ * accounted for.
+ *
+ * @param streamId 
+ * @param table the table the page belongs to
+ * @param pageId 
+ */
+void BufferManager::schedulePrefetch(int streamId, Table *table, PageId pageId)
+{
+    lock_guard<mutex> prefetchLock(this->prefetchMutex);
+    auto stream = this->streams.find(streamId);
+    bool sequential = stream != this->streams.end() &&
+                      stream->second.tableName == pageId.tableName &&
+                      stream->second.pageIndex + 1 == pageId.pageIndex;
+    if (stream == this->streams.end() && this->streams.size() >= 64)
+        this->streams.clear();
+    this->streams[streamId] = pageId;
+    if (!sequential || PREFETCH_DEPTH == 0)
+        return;
+
+    long long available = (long long)BUFFER_BYTES - this->pinnedBytes;
+    for (auto &pending : this->prefetchPending)
+        available -= pending.second;
+    int lastPage = min(pageId.pageIndex + (int)PREFETCH_DEPTH, (int)table->blockCount - 1);
+    bool queued = false;
+    for (int pageIndex = pageId.pageIndex + 1; pageIndex <= lastPage; pageIndex++)
+    {
+        PageId nextPageId = {pageId.tableName, pageIndex};
+        if (this->prefetchPending.count(nextPageId))
+            continue;
+        PoolShard &shard = this->shardFor(nextPageId);
+        {
+            lock_guard<mutex> lock(shard.shardMutex);
+            if (this->frameFor(shard, nextPageId) != -1)
+                continue;
+        }
+        int rowCount = table->rowsPerBlockCount[pageIndex];
+        size_t byteCount = getPageByteCount(rowCount, table->columnCount);
+        if ((long long)byteCount > available)
+            break;
+        this->prefetchQueue.push_back({nextPageId, rowCount, (int)table->columnCount});
+        this->prefetchPending[nextPageId] = byteCount;
+        available -= byteCount;
+        queued = true;
+    }
+    if (!queued)
+        return;
+    logger.log("BufferManager::schedulePrefetch");
+    if (!this->prefetchThread.joinable())
+        this->prefetchThread = thread(&BufferManager::prefetchPages, this);
+    this->prefetchQueued.notify_one();
+}
+
+/**
+ * @brief Withdraws the prefetch of a page, either because it is needed right
+ * away or because it is being deleted. A read already under way is not
+ * interrupted but its result is thrown away. The caller holds prefetchMutex.
+ *
+ * @param pageId 
+ */
+void BufferManager::cancelPrefetch(PageId pageId)
+{
+    if (!this->prefetchPending.erase(pageId))
+        return;
+    if (this->prefetchInFlight == pageId)
+    {
+        this->prefetchInFlightCancelled = true;
+        return;
+    }
+    for (auto request = this->prefetchQueue.begin(); request != this->prefetchQueue.end(); request++)
+        if (request->pageId == pageId)
+        {
+            this->prefetchQueue.erase(request);
+            return;
+        }
+}
+
+/**
+ * @brief Withdraws the prefetch of a page and waits for a read of it that is
+ * already under way, so the page can be looked up in or removed from its
+ * shard without the prefetch thread racing in afterwards.
+ *
+ * @param pageId 
+ */
+void BufferManager::discardPrefetch(PageId pageId)
+{
+    unique_lock<mutex> prefetchLock(this->prefetchMutex);
+    this->cancelPrefetch(pageId);
+    this->prefetchFinished.wait(prefetchLock, [&] {
+        return !(this->prefetchInFlight == pageId);
+    });
+}
+
+/**
+ * @brief Body of the prefetch thread. Pages are read without holding any lock
+ * and only inserted if they are still wanted and a frame can be had without
+ * growing the pool.
+ *
+ */
+void BufferManager::prefetchPages()
+{
+    unique_lock<mutex> prefetchLock(this->prefetchMutex);
+    while (true)
+    {
+        this->prefetchQueued.wait(prefetchLock, [this] {
+            return this->stopPrefetching || !this->prefetchQueue.empty();
+        });
+        if (this->stopPrefetching)
+            return;
+        PrefetchRequest request = this->prefetchQueue.front();
+        this->prefetchQueue.pop_front();
+        this->prefetchInFlight = request.pageId;
+        this->prefetchInFlightCancelled = false;
+
+        prefetchLock.unlock();
+        Page page(request.pageId.tableName, request.pageId.pageIndex, request.rowCount, request.columnCount);
+        prefetchLock.lock();
+
+        if (!this->prefetchInFlightCancelled)
+        {
+            PoolShard &shard = this->shardFor(request.pageId);
+            lock_guard<mutex> lock(shard.shardMutex);
+            Frame *frame = nullptr;
+            if (this->frameFor(shard, request.pageId) == -1)
+                frame = this->placePage(shard, request.pageId, getPageByteCount(request.rowCount, request.columnCount), false);
+            if (frame)
+            {
+                frame->page = move(page);
+                frame->prefetched = true;
+                this->prefetchCount++;
+            }
+        }
+        this->prefetchPending.erase(request.pageId);
+        this->prefetchInFlight = {"", -1};
+        this->prefetchFinished.notify_all();
+    }
+}
+
+/**
+ * @brief Writes the page held in a dirty frame to disk.
+ *
+ * @param frame 
+ */
+void BufferManager::flushFrame(Frame &frame)
+{
+    logger.log("BufferManager::flushFrame");
+    frame.page.writePage();
+    frame.dirty = false;
+    this->writeBackCount++;
 }
 
 /**
  * @brief The buffer manager is also responsible for writing pages. This is
- * called when new tables are created using assignment statements.
+ * called when new tables are created using assignment statements. The page
+ * is placed in the pool as a dirty frame and only reaches the disk once it is
+ * evicted or its table is exported. A previous version of the page still in
+ * the pool is dropped.
  *
  * @param tableName 
  * @param pageIndex 
- * @param rows 
+ * @param cells rows of the page in row major order
  * @param rowCount 
+ * @param columnCount 
  */
-void BufferManager::writePage(string tableName, int pageIndex, vector<vector<int>> rows, int rowCount)
+void BufferManager::writePage(string tableName, int pageIndex, const vector<int> &cells, int rowCount, int columnCount)
 {
     logger.log("BufferManager::writePage");
-    Page page(tableName, pageIndex, rows, rowCount);
-    page.writePage();
+    PageId pageId = {tableName, pageIndex};
+    this->discardPrefetch(pageId);
+    PoolShard &shard = this->shardFor(pageId);
+    lock_guard<mutex> lock(shard.shardMutex);
+    int frameIndex = this->frameFor(shard, pageId);
+    if (frameIndex != -1)
+        this->evictFrame(shard, frameIndex, false);
+    Frame *frame = this->placePage(shard, pageId, getPageByteCount(rowCount, columnCount), true);
+    frame->page = Page(tableName, pageIndex, cells, rowCount, columnCount);
+    frame->dirty = true;
+}
+
+/**
+ * @brief Writes every dirty page of the table to disk. The pages stay in the
+ * pool.
+ *
+ * @param tableName 
+ */
+void BufferManager::flushTable(string tableName)
+{
+    logger.log("BufferManager::flushTable");
+    for (auto &shard : this->shards)
+    {
+        lock_guard<mutex> lock(shard->shardMutex);
+        for (Frame &frame : shard->frames)
+            if (frame.occupied && frame.dirty && frame.pageId.tableName == tableName)
+                this->flushFrame(frame);
+    }
 }
 
 /**
@@ -107,8 +595,10 @@ void BufferManager::deleteFile(string fileName)
 }
 
 /**
- * @brief Overloaded function that calls deleteFile(fileName) by constructing
- * the fileName from the tableName and pageIndex.
+ * @brief Drops the page from the pool without writing it back. With text
+ * pages it also calls deleteFile(fileName) by constructing the fileName from
+ * the tableName and pageIndex; binary pages live in the table's segment which
+ * is deleted as a whole.
  *
  * @param tableName 
  * @param pageIndex 
@@ -116,6 +606,232 @@ void BufferManager::deleteFile(string fileName)
 void BufferManager::deleteFile(string tableName, int pageIndex)
 {
     logger.log("BufferManager::deleteFile");
+    PageId pageId = {tableName, pageIndex};
+    this->discardPrefetch(pageId);
+    {
+        PoolShard &shard = this->shardFor(pageId);
+        lock_guard<mutex> lock(shard.shardMutex);
+        int frameIndex = this->frameFor(shard, pageId);
+        if (frameIndex != -1)
+            this->evictFrame(shard, frameIndex, false);
+    }
+    if (!TEXT_PAGES)
+        return;
     string fileName = "../data/temp/"+tableName + "_Page" + to_string(pageIndex);
     this->deleteFile(fileName);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Writes the pool counters to the log so runs with different
+ * replacement policies can be compared.
+ *
+ */
+void BufferManager::logStatistics()
+{
+    logger.log("BufferManager::logStatistics: policy=" + this->getReplacementPolicyName() +
+               " shards=" + to_string(this->shards.size()) +
+               " hits=" + to_string(this->hitCount) +
+               " misses=" + to_string(this->missCount) +
+               " evictions=" + to_string(this->evictionCount) +
+               " prefetches=" + to_string(this->prefetchCount) +
+               " writebacks=" + to_string(this->writeBackCount));
+}
+
+int BufferManager::getPoolShardCount()
+{
+    return this->shards.size();
+}
+
+/**
+ * @brief Bytes of the frames that are pinned at the moment.
+ *
+ * @return long long 
+ */
+long long BufferManager::getPinnedBytes()
+{
+    return this->pinnedBytes;
+}
+
+/**
+ * @brief Checks the bookkeeping of every shard once no page is pinned: each
+ * frame is either occupied and entered under its page in the page table, or
+ * empty and on the free list exactly once, no frame is pinned and the bytes
+ * of the occupied frames add up to the shard's pool bytes. Waits for the
+ * prefetch thread to finish its queue first. Used by the buffer stress test.
+ *
+ * @param problem describes the first inconsistency found
+ * @return true if the pool is consistent
+ * @return false otherwise
+ */
+bool BufferManager::checkFrames(string &problem)
+{
+    logger.log("BufferManager::checkFrames");
+    unique_lock<mutex> prefetchLock(this->prefetchMutex);
+    this->prefetchFinished.wait(prefetchLock, [this] {
+        return this->prefetchQueue.empty() && this->prefetchInFlight == PageId{"", -1};
+    });
+    if (this->pinnedBytes != 0)
+    {
+        problem = to_string(this->pinnedBytes) + " bytes still pinned";
+        return false;
+    }
+    for (auto &shard : this->shards)
+    {
+        lock_guard<mutex> lock(shard->shardMutex);
+        string shardName = "shard " + to_string(shard->shardIndex) + ": ";
+        vector<int> freeCounts(shard->frames.size(), 0);
+        for (int frameIndex : shard->freeFrames)
+            freeCounts[frameIndex]++;
+        size_t poolBytes = 0;
+        size_t occupiedCount = 0;
+        for (Frame &frame : shard->frames)
+        {
+            string frameName = shardName + "frame " + to_string(frame.frameIndex);
+            if (frame.pinCount != 0)
+            {
+                problem = frameName + " pinned " + to_string(frame.pinCount) + " times";
+                return false;
+            }
+            if (frame.loading)
+            {
+                problem = frameName + " still loading";
+                return false;
+            }
+            if (!frame.occupied)
+            {
+                if (freeCounts[frame.frameIndex] != 1)
+                {
+                    problem = frameName + " is empty but on the free list " + to_string(freeCounts[frame.frameIndex]) + " times";
+                    return false;
+                }
+                continue;
+            }
+            if (freeCounts[frame.frameIndex] != 0)
+            {
+                problem = frameName + " is occupied but on the free list";
+                return false;
+            }
+            if (this->frameFor(*shard, frame.pageId) != frame.frameIndex)
+            {
+                problem = frameName + " holds " + frame.pageId.tableName + "[" + to_string(frame.pageId.pageIndex) +
+                          "] but is not in the page table under it";
+                return false;
+            }
+            poolBytes += frame.byteCount;
+            occupiedCount++;
+        }
+        if (shard->pageTable.size() != occupiedCount)
+        {
+            problem = shardName + to_string(shard->pageTable.size()) + " pages in the page table, " +
+                      to_string(occupiedCount) + " occupied frames";
+            return false;
+        }
+        if (shard->poolBytes != poolBytes)
+        {
+            problem = shardName + "pool bytes " + to_string(shard->poolBytes) + ", occupied frames hold " + to_string(poolBytes);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Takes over a pin the buffer manager has already placed on the frame.
+ *
+ * @param frame 
+ */
+PageHandle::PageHandle(Frame *frame)
+{
+    this->frame = frame;
+}
+
+PageHandle::PageHandle(const PageHandle &other)
+{
+    this->frame = other.frame;
+    if (this->frame)
+        this->frame->pinCount++;
+}
+
+PageHandle::PageHandle(PageHandle &&other)
+{
+    this->frame = other.frame;
+    other.frame = nullptr;
+}
+
+PageHandle &PageHandle::operator=(const PageHandle &other)
+{
+    if (other.frame)
+        other.frame->pinCount++;
+    this->release();
+    this->frame = other.frame;
+    return *this;
+}
+
+PageHandle &PageHandle::operator=(PageHandle &&other)
+{
+    if (this != &other)
+    {
+        this->release();
+        this->frame = other.frame;
+        other.frame = nullptr;
+    }
+    return *this;
+}
+
+PageHandle::~PageHandle()
+{
+    this->release();
+}
+
+const Page &PageHandle::operator*() const
+{
+    return this->frame->page;
+}
+
+const Page *PageHandle::operator->() const
+{
+    return &this->frame->page;
+}
+
+bool PageHandle::isValid() const
+{
+    return this->frame != nullptr;
+}
+
+/**
+ * @brief Unpins the frame. The handle refers to no page afterwards.
+ *
+ */
+void PageHandle::release()
+{
+    if (this->frame)
+        bufferManager.unpinFrame(this->frame);
+    this->frame = nullptr;
+}
+
+/**
+ * @brief Parses a byte count as typed by the user, a whole number optionally
+ * followed by K, M or G for KiB, MiB or GiB.
+ *
+ * @param text 
+ * @param byteCount set when the text is a valid byte count
+ * @return true if text is a valid non-zero byte count
+ * @return false otherwise
+ */
+bool parseByteCount(string text, size_t &byteCount)
+{
+    size_t multiplier = 1;
+    if (!text.empty())
+    {
+        char unit = toupper(text.back());
+        if (unit == 'K' || unit == 'M' || unit == 'G')
+        {
+            multiplier = unit == 'K' ? 1ull << 10 : unit == 'M' ? 1ull << 20 : 1ull << 30;
+            text.pop_back();
+        }
+    }
+    if (text.empty() || text.size() > 12 || text.find_first_not_of("0123456789") != string::npos)
+        return false;
+    byteCount = stoull(text) * multiplier;
+    return byteCount > 0;
+}
@@ -1,38 +1,208 @@
+#ifndef BUFFERMANAGER_H
+#define BUFFERMANAGER_H
 #include"page.h"
+#include"replacementPolicy.h"
+#include"segmentManager.h"
+
+class Table;
+
+/**
+ * @brief A frame is a slot of the buffer pool that can hold one page. A frame
+ * with a non-zero pin count is in use by a reader and is never evicted. The
+ * pin count is atomic because handles are copied without taking any lock. A
+ * loading frame already belongs to its page but the page is still being read
+ * from disk; other readers of the page wait for it on the frame's shard. A
+ * prefetched frame has not been pinned since its page was read ahead, a dirty
+ * frame holds a page that has been written to the pool but not yet to disk.
+ *
+ */
+struct Frame
+{
+    int frameIndex = -1;
+    int shardIndex = -1;
+    PageId pageId;
+    Page page;
+    bool occupied = false;
+    bool loading = false;
+    bool prefetched = false;
+    bool dirty = false;
+    size_t byteCount = 0;
+    atomic<int> pinCount{0};
+};
+
+/**
+ * @brief A PoolShard is an independent part of the buffer pool with its own
+ * lock, page table, frames, replacement policy and share of the memory
+ * budget. A page always lives in the shard its PageId hashes to, so threads
+ * working on pages of different shards never wait for each other.
+ *
+ */
+struct PoolShard
+{
+    int shardIndex = 0;
+    mutex shardMutex;
+    condition_variable frameLoaded;
+    deque<Frame> frames;
+    vector<int> freeFrames;
+    unordered_map<PageId, int, PageIdHash> pageTable;
+    ReplacementPolicy *policy = nullptr;
+    size_t poolBytes = 0;
+    size_t byteBudget = 0;
+
+    ~PoolShard() { delete policy; }
+};
+
+/**
+ * @brief A page the prefetch thread has been asked to read. The page's
+ * dimensions are taken from the catalogue when the request is made so the
+ * thread itself never touches the catalogue.
+ *
+ */
+struct PrefetchRequest
+{
+    PageId pageId;
+    int rowCount;
+    int columnCount;
+};
+
+/**
+ * @brief A PageHandle keeps the page it refers to pinned in the buffer pool
+ * for as long as the handle (or any copy of it) is alive, so rows can be read
+ * straight out of the frame instead of out of a private copy of the page.
+ * Releasing or destroying the handle unpins the frame.
+ *
+ */
+class PageHandle
+{
+    Frame *frame = nullptr;
+
+public:
+    PageHandle() {}
+    PageHandle(Frame *frame);
+    PageHandle(const PageHandle &other);
+    PageHandle(PageHandle &&other);
+    PageHandle &operator=(const PageHandle &other);
+    PageHandle &operator=(PageHandle &&other);
+    ~PageHandle();
+    const Page &operator*() const;
+    const Page *operator->() const;
+    bool isValid() const;
+    void release();
+};
 
 /**
  * @brief The BufferManager is responsible for reading pages to the main memory.
  * Recall that large files are broken and stored as blocks in the hard disk. The
  * minimum amount of memory that can be read from the disk is a block whose size
- * is indicated by BLOCK_SIZE. within this system we simulate blocks by
- * splitting and storing the file as multiple files each of one BLOCK_SIZE,
- * although this isn't traditionally how it's done. You can alternatively just
- * random access to the point where a block begins within the same
- * file. In this system we assume that the the sizes of blocks and pages are the
- * same. 
- * 
+ * is indicated by BLOCK_SIZE, or by the block size given when the table was
+ * loaded. Within this system all blocks of a relation are
+ * stored in one segment file and a block is read by random access to the point
+ * where it begins (see SegmentManager). With --text-pages every block is
+ * instead stored as a separate text file. In this system we assume that the
+ * the sizes of blocks and pages are the same.
+ *
+ * <p>
+ * The buffer holds as many pages as fit into a memory budget of BUFFER_BYTES,
+ * set at startup with --buffer-bytes or later with SET BUFFER, so a pool holds
+ * more pages of a narrow table than of a wide one. BLOCK_COUNT is derived from
+ * the budget as the number of full pages of BLOCK_SIZE it holds. Which frame
+ * is given up when the pool is full is decided by a pluggable
+ * ReplacementPolicy (FIFO, LRU, CLOCK or the scan resistant 2Q). Readers pin
+ * the frames they are reading through a PageHandle and pinned frames are
+ * skipped when looking for a victim; if every frame is pinned the pool
+ * temporarily grows past its budget and shrinks back on later insertions.
+ * With --mmap a frame holds a mapped window of the segment rather than a copy
+ * of the page, so the budget limits how much of the segments is mapped at a
+ * time. This replacement policy should be transparent to the executors i.e.
+ * the executor should not know if a block was previously present in the
+ * buffer or was read in from the disk.
+ * </p>
+ * <p>
+ * The pool may be used from several threads at once. Large pools are split
+ * into up to MAX_SHARD_COUNT shards, each with its own lock, hash table of
+ * frames keyed by (table, page index), policy and slice of the budget; small
+ * pools use a single shard so eviction order stays exactly that of the
+ * policy. No lock is held while a page is read from disk: the frame is
+ * reserved and marked loading first, and readers of the same page wait for
+ * that one read to finish.
+ * </p>
  * <p>
- * The buffer can hold multiple pages quantified by BLOCK_COUNT. The
- * buffer manager follows the FIFO replacement policy i.e. the first block to be
- * read in is replaced by the new incoming block. This replacement policy should
- * be transparent to the executors i.e. the executor should not know if a block
- * was previously present in the buffer or was read in from the disk. 
+ * Cursors identify themselves with a stream id when pinning pages. When a
+ * stream pins the page right after the one it pinned last, the scan is taken
+ * to be sequential and the next PREFETCH_DEPTH pages are handed to a
+ * background I/O thread, so they are usually in the pool by the time the
+ * cursor reaches them. Prefetched pages only ever take free or evictable
+ * frames, never more than fit into the budget, and a page that is pinned
+ * while its prefetch is still under way is waited for rather than read twice.
+ * </p>
+ * <p>
+ * Pages written through writePage go into the pool as dirty frames instead of
+ * straight to disk, so a result that is read right after it was written, for
+ * instance by the next statement of a chain of assignments, is served from
+ * memory. A dirty page is written out when its frame is evicted or when its
+ * table is exported; pages of a table that is cleared are dropped without
+ * ever being written.
  * </p>
  *
  */
 class BufferManager{
 
-    deque<Page> pages; 
-    bool inPool(string pageName);
-    Page getFromPool(string pageName);
-    Page insertIntoPool(string tableName, int pageIndex);
+    vector<unique_ptr<PoolShard>> shards;
+    ReplacementStrategy strategy = FIFO_REPLACEMENT;
+    atomic<long long> pinnedBytes{0};
+
+    mutex prefetchMutex;
+    unordered_map<int, PageId> streams;
+    deque<PrefetchRequest> prefetchQueue;
+    unordered_map<PageId, size_t, PageIdHash> prefetchPending;
+    PageId prefetchInFlight = {"", -1};
+    bool prefetchInFlightCancelled = false;
+    condition_variable prefetchQueued;
+    condition_variable prefetchFinished;
+    thread prefetchThread;
+    bool stopPrefetching = false;
+
+    PoolShard &shardFor(const PageId &pageId);
+    void buildShards(int shardCount);
+    int frameFor(PoolShard &shard, const PageId &pageId);
+    int allocateFrame(PoolShard &shard, size_t byteCount, bool mayGrow);
+    Frame *placePage(PoolShard &shard, const PageId &pageId, size_t byteCount, bool mayGrow);
+    void evictFrame(PoolShard &shard, int frameIndex, bool writeBack = true);
+    void trimShard(PoolShard &shard);
+    void flushFrame(Frame &frame);
+    void pinFrame(Frame *frame);
+    void schedulePrefetch(int streamId, Table *table, PageId pageId);
+    void cancelPrefetch(PageId pageId);
+    void discardPrefetch(PageId pageId);
+    void prefetchPages();
 
     public:
-    
+
+    static constexpr int MAX_SHARD_COUNT = 16;
+    static constexpr int MIN_BLOCKS_PER_SHARD = 64;
+
+    atomic<long long> hitCount{0};
+    atomic<long long> missCount{0};
+    atomic<long long> evictionCount{0};
+    atomic<long long> prefetchCount{0};
+    atomic<long long> writeBackCount{0};
+
     BufferManager();
-    Page getPage(string tableName, int pageIndex);
-    void writePage(string pageName, vector<vector<int>> rows);
+    ~BufferManager();
+    void setReplacementPolicy(ReplacementStrategy strategy);
+    string getReplacementPolicyName();
+    void setBufferBytes(size_t byteCount);
+    PageHandle pinPage(Table *table, int pageIndex, int streamId = -1);
+    void unpinFrame(Frame *frame);
     void deleteFile(string tableName, int pageIndex);
     void deleteFile(string fileName);
-    void writePage(string tableName, int pageIndex, vector<vector<int>> rows, int rowCount);
-};
\ No newline at end of file
+    void writePage(string tableName, int pageIndex, const vector<int> &cells, int rowCount, int columnCount);
+    void flushTable(string tableName);
+    void logStatistics();
+    int getPoolShardCount();
+    long long getPinnedBytes();
+    bool checkFrames(string &problem);
+};
+
+bool parseByteCount(string text, size_t &byteCount);
+#endif
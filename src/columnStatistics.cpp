@@ -0,0 +1,150 @@
+#include "global.h"
+
+HyperLogLog::HyperLogLog()
+{
+    this->registers.assign(1 << PRECISION, 0);
+}
+
+/**
+ * @brief Spreads the bits of a value over a 64 bit hash (the finaliser of
+ * splitmix64), so neighbouring values land in unrelated registers.
+ *
+ * @param value 
+ * @return uint64_t 
+ */
+static uint64_t hashValue(int value)
+{
+    uint64_t hash = (uint32_t)value;
+    hash += 0x9e3779b97f4a7c15ull;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * @brief The top PRECISION bits of the hash pick a register, which keeps the
+ * largest position of the first set bit seen among the remaining bits.
+ *
+ * @param value 
+ */
+void HyperLogLog::add(int value)
+{
+    uint64_t hash = hashValue(value);
+    uint32_t registerIndex = hash >> (64 - PRECISION);
+    uint64_t remainder = (hash << PRECISION) | (1ull << (PRECISION - 1));
+    uint8_t rank = __builtin_clzll(remainder) + 1;
+    if (rank > this->registers[registerIndex])
+        this->registers[registerIndex] = rank;
+}
+
+void HyperLogLog::merge(const HyperLogLog &other)
+{
+    for (size_t registerIndex = 0; registerIndex < this->registers.size(); registerIndex++)
+        this->registers[registerIndex] = max(this->registers[registerIndex], other.registers[registerIndex]);
+}
+
+/**
+ * @brief The harmonic mean estimate of HyperLogLog, with linear counting
+ * taking over for small cardinalities where some registers are still empty.
+ *
+ * @return double 
+ */
+double HyperLogLog::estimate() const
+{
+    double registerCount = this->registers.size();
+    double sum = 0;
+    int emptyRegisters = 0;
+    for (uint8_t rank : this->registers)
+    {
+        sum += ldexp(1.0, -rank);
+        if (rank == 0)
+            emptyRegisters++;
+    }
+    double alpha = 0.7213 / (1 + 1.079 / registerCount);
+    double estimate = alpha * registerCount * registerCount / sum;
+    if (estimate <= 2.5 * registerCount && emptyRegisters)
+        estimate = registerCount * log(registerCount / emptyRegisters);
+    return estimate;
+}
+
+/**
+ * @brief Gives up exact counting once the column has more distinct values
+ * than EXACT_DISTINCT_LIMIT.
+ *
+ */
+void ColumnStatistics::checkExactLimit()
+{
+    if (this->exact && this->exactValues.size() > EXACT_DISTINCT_LIMIT)
+    {
+        this->exact = false;
+        unordered_set<int>().swap(this->exactValues);
+    }
+}
+
+void ColumnStatistics::add(int value)
+{
+    this->valueCount++;
+    this->minValue = min(this->minValue, value);
+    this->maxValue = max(this->maxValue, value);
+    this->sketch.add(value);
+    if (this->exact)
+    {
+        this->exactValues.insert(value);
+        this->checkExactLimit();
+    }
+}
+
+/**
+ * @brief Adds the statistics of another part of the same column. The exact
+ * values of other are taken over, so other should not be used afterwards.
+ *
+ * @param other 
+ */
+void ColumnStatistics::merge(ColumnStatistics &other)
+{
+    this->valueCount += other.valueCount;
+    this->minValue = min(this->minValue, other.minValue);
+    this->maxValue = max(this->maxValue, other.maxValue);
+    this->sketch.merge(other.sketch);
+    this->exact = this->exact && other.exact;
+    if (!this->exact)
+        unordered_set<int>().swap(this->exactValues);
+    else if (this->exactValues.size() < other.exactValues.size())
+        this->exactValues.swap(other.exactValues);
+    if (this->exact)
+        this->exactValues.insert(other.exactValues.begin(), other.exactValues.end());
+    unordered_set<int>().swap(other.exactValues);
+    this->checkExactLimit();
+}
+
+/**
+ * @brief Number of distinct values of the column, exact if
+ * isDistinctCountExact and a HyperLogLog estimate otherwise.
+ *
+ * @return uint 
+ */
+uint ColumnStatistics::getDistinctCount() const
+{
+    if (this->exact)
+        return max(this->exactValues.size(), this->releasedCount);
+    long long estimate = llround(this->sketch.estimate());
+    return min(max(estimate, (long long)EXACT_DISTINCT_LIMIT + 1), this->valueCount);
+}
+
+bool ColumnStatistics::isDistinctCountExact() const
+{
+    return this->exact;
+}
+
+/**
+ * @brief Frees the exact values once loading is done; the exact count is
+ * kept.
+ *
+ */
+void ColumnStatistics::releaseExactValues()
+{
+    if (!this->exact)
+        return;
+    this->releasedCount = this->exactValues.size();
+    unordered_set<int>().swap(this->exactValues);
+}
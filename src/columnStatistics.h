@@ -0,0 +1,55 @@
+#ifndef COLUMNSTATISTICS_H
+#define COLUMNSTATISTICS_H
+#include "logger.h"
+
+/**
+ * @brief A HyperLogLog sketch estimates the number of distinct values added to
+ * it in a fixed 2^PRECISION bytes of memory, with a standard error of about
+ * 1.04 / sqrt(2^PRECISION), i.e. under one percent. Sketches built over
+ * different parts of the same column can be merged.
+ *
+ */
+class HyperLogLog
+{
+    static const int PRECISION = 14;
+
+    vector<uint8_t> registers;
+
+public:
+    HyperLogLog();
+    void add(int value);
+    void merge(const HyperLogLog &other);
+    double estimate() const;
+};
+
+/**
+ * @brief Statistics of one column gathered in a single pass while a table is
+ * loaded: how many values the column holds, its smallest and largest value
+ * and its number of distinct values. Distinct values are counted exactly as
+ * long as there are at most EXACT_DISTINCT_LIMIT of them and estimated with a
+ * HyperLogLog sketch beyond that, so the memory used stays bounded however
+ * large the table is.
+ *
+ */
+class ColumnStatistics
+{
+    HyperLogLog sketch;
+    unordered_set<int> exactValues;
+    size_t releasedCount = 0;
+    bool exact = true;
+
+    void checkExactLimit();
+
+public:
+    long long valueCount = 0;
+    int minValue = INT_MAX;
+    int maxValue = INT_MIN;
+
+    void add(int value);
+    void merge(ColumnStatistics &other);
+    uint getDistinctCount() const;
+    bool isDistinctCountExact() const;
+    void releaseExactValues();
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "global.h"
+
+CsvReader::CsvReader(string fileName)
+{
+    logger.log("CsvReader::CsvReader");
+    this->fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    this->buffer.resize(CHUNK_SIZE);
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (this->fileDescriptor != -1)
+        posix_fadvise(this->fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+/**
+ * @brief Construct a new CsvReader:: CsvReader object that only reads the
+ * bytes [beginOffset, endOffset) of the file. beginOffset is expected to be
+ * the start of a line.
+ *
+ * @param fileName 
+ * @param beginOffset 
+ * @param endOffset 
+ */
+CsvReader::CsvReader(string fileName, off_t beginOffset, off_t endOffset) : CsvReader(fileName)
+{
+    this->offset = beginOffset;
+    this->endOffset = endOffset;
+}
+
+CsvReader::~CsvReader()
+{
+    if (this->fileDescriptor != -1)
+        close(this->fileDescriptor);
+}
+
+bool CsvReader::isOpen() const
+{
+    return this->fileDescriptor != -1;
+}
+
+/**
+ * @brief Moves the unfinished line to the front of the buffer and reads the
+ * next chunk of the reader's range behind it. The buffer is doubled when a
+ * single line does not fit into it.
+ *
+ * @return true if more data was read
+ * @return false at the end of the range or on a read error
+ */
+bool CsvReader::fill()
+{
+    size_t carried = this->dataEnd - this->lineStart;
+    if (carried && this->lineStart)
+        memmove(this->buffer.data(), this->buffer.data() + this->lineStart, carried);
+    this->lineStart = 0;
+    this->dataEnd = carried;
+    if (this->buffer.size() - this->dataEnd < CHUNK_SIZE / 2)
+        this->buffer.resize(this->buffer.size() * 2);
+    size_t byteCount = this->buffer.size() - this->dataEnd;
+    if (this->endOffset != -1)
+        byteCount = min<off_t>(byteCount, max<off_t>(0, this->endOffset - this->offset));
+    ssize_t bytesRead = 0;
+    if (byteCount)
+        do
+            bytesRead = pread(this->fileDescriptor, this->buffer.data() + this->dataEnd, byteCount, this->offset);
+        while (bytesRead == -1 && errno == EINTR);
+    if (bytesRead <= 0)
+    {
+        this->endOfFile = true;
+        return false;
+    }
+    this->dataEnd += bytesRead;
+    this->offset += bytesRead;
+    return true;
+}
+
+/**
+ * @brief Hands out the next line without its newline, like getline. A last
+ * line that is not terminated by a newline is still returned.
+ *
+ * @param begin
+ * @param end
+ * @return true if a line was read
+ * @return false at the end of the file
+ */
+bool CsvReader::nextLine(const char *&begin, const char *&end)
+{
+    if (!this->isOpen())
+        return false;
+    size_t scanFrom = this->lineStart;
+    while (true)
+    {
+        char *data = this->buffer.data();
+        const char *newline = (const char *)memchr(data + scanFrom, '\n', this->dataEnd - scanFrom);
+        if (newline)
+        {
+            begin = data + this->lineStart;
+            end = newline;
+            this->lineStart = newline - data + 1;
+            return true;
+        }
+        if (this->endOfFile)
+        {
+            if (this->lineStart == this->dataEnd)
+                return false;
+            begin = data + this->lineStart;
+            end = data + this->dataEnd;
+            this->lineStart = this->dataEnd;
+            return true;
+        }
+        scanFrom = this->dataEnd - this->lineStart;
+        this->fill();
+    }
+}
+
+/**
+ * @brief Offset in the file of the line the next call to nextLine returns.
+ *
+ * @return off_t 
+ */
+off_t CsvReader::getLineOffset() const
+{
+    return this->offset - (off_t)(this->dataEnd - this->lineStart);
+}
+
+/**
+ * @brief Converts the field starting at position the way stoi converts the
+ * string getline(s, word, ',') would have produced: leading whitespace is
+ * skipped, an optional sign and decimal digits are read and anything after
+ * them is ignored. position is moved past the field and its comma.
+ *
+ * @param position start of the field, moved to the start of the next one
+ * @param end end of the line
+ * @param value set to the converted field
+ * @return true if there was a field to convert
+ * @return false if the line has no more fields
+ * @throws invalid_argument if the field does not start with a number
+ * @throws out_of_range if the number does not fit into an int
+ */
+bool parseField(const char *&position, const char *end, int &value)
+{
+    if (position >= end)
+        return false;
+    const char *comma = (const char *)memchr(position, ',', end - position);
+    const char *fieldEnd = comma ? comma : end;
+    const char *digits = position;
+    position = comma ? comma + 1 : end;
+
+    while (digits < fieldEnd && isspace((unsigned char)*digits))
+        digits++;
+    if (digits + 1 < fieldEnd && *digits == '+' && isdigit((unsigned char)digits[1]))
+        digits++;
+    from_chars_result result = from_chars(digits, fieldEnd, value);
+    if (result.ec == errc::invalid_argument)
+        throw invalid_argument("stoi");
+    if (result.ec == errc::result_out_of_range)
+        throw out_of_range("stoi");
+    return true;
+}
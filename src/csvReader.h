@@ -0,0 +1,46 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+#include "ioStatistics.h"
+
+/**
+ * @brief The CsvReader reads a CSV file line by line for bulk loading. The
+ * file is read in large chunks with positioned reads and lines and fields are
+ * found with memchr, so no line or field is ever copied into a string. Lines
+ * are handed out as [begin, end) ranges into the reader's buffer and stay
+ * valid until the next call to nextLine. A reader may be limited to a byte
+ * range of the file, so several readers can work through one file in
+ * parallel.
+ *
+ * <p>
+ * Lines and fields are split exactly as getline would split them and fields
+ * are converted with the rules of stoi, so a malformed file is rejected (or
+ * accepted) just as it was when rows were parsed through a stringstream.
+ * </p>
+ *
+ */
+class CsvReader
+{
+    static const size_t CHUNK_SIZE = 1 << 20;
+
+    int fileDescriptor = -1;
+    off_t offset = 0;
+    off_t endOffset = -1;
+    vector<char> buffer;
+    size_t lineStart = 0;
+    size_t dataEnd = 0;
+    bool endOfFile = false;
+
+    bool fill();
+
+public:
+    CsvReader(string fileName);
+    CsvReader(string fileName, off_t beginOffset, off_t endOffset);
+    ~CsvReader();
+    bool isOpen() const;
+    bool nextLine(const char *&begin, const char *&end);
+    off_t getLineOffset() const;
+};
+
+bool parseField(const char *&position, const char *end, int &value);
+
+#endif
@@ -1,12 +1,15 @@
 #include "global.h"
 
-Cursor::Cursor(string tableName, int pageIndex)
+Cursor::Cursor(Table *table, int pageIndex)
 {
     logger.log("Cursor::Cursor");
     // cout << tableName << " " << pageIndex << endl;
-    this->page = bufferManager.getPage(tableName, pageIndex);
+    static atomic<int> cursorCount{0};
+    this->cursorId = cursorCount++;
+    this->page = bufferManager.pinPage(table, pageIndex, this->cursorId);
     this->pagePointer = 0;
-    this->tableName = tableName;
+    this->table = table;
+    this->tableName = table->tableName;
     this->pageIndex = pageIndex;
 }
  
@@ -20,27 +23,97 @@ Cursor::Cursor(string tableName, int pageIndex)
 vector<int> Cursor::getNext()
 {
     logger.log("Cursor::geNext");
-    vector<int> result = this->page.getRow(this->pagePointer);
-    this->pagePointer++;
-    if(result.empty()){
-        tableCatalogue.getTable(this->tableName)->getNextPage(this);
-        if(!this->pagePointer){
-            result = this->page.getRow(this->pagePointer);
-            this->pagePointer++;
+    return this->getNextRow().toVector();
+}
+
+/**
+ * @brief Same as getNext but returns a view of the row inside the pinned page
+ * instead of a copy. The view is valid until the cursor moves to another
+ * page.
+ *
+ * @return RowView empty once all rows have been read
+ */
+RowView Cursor::getNextRow()
+{
+    if (this->pagePointer >= this->page->getRowCount())
+    {
+        this->pagePointer++;
+        this->table->getNextPage(this);
+        if (this->pagePointer)
+            return RowView();
+    }
+    return this->page->getRow(this->pagePointer++);
+}
+/**
+ * @brief Reads up to maxRowCount rows at once. The rows handed out all come
+ * from the current page; once it is used up the cursor moves to the next page
+ * of the table. If a projection has been set only the projected columns are
+ * returned, in projection order.
+ *
+ * @param batch filled with the rows read
+ * @param maxRowCount 
+ * @return int number of rows in the batch, 0 once all rows have been read
+ */
+int Cursor::getNextBatch(RowBatch &batch, int maxRowCount)
+{
+    logger.log("Cursor::getNextBatch");
+    batch.rowCount = 0;
+    if (this->pagePointer >= this->page->getRowCount())
+    {
+        this->pagePointer++;
+        this->table->getNextPage(this);
+        if (this->pagePointer)
+            return 0;
+    }
+    int rowCount = min(maxRowCount, this->page->getRowCount() - this->pagePointer);
+    const int *cells = this->page->getRowData(this->pagePointer);
+    int columnCount = this->page->getColumnCount();
+    this->pagePointer += rowCount;
+
+    if (this->projection.empty())
+    {
+        batch.cells = cells;
+        batch.columnCount = columnCount;
+    }
+    else
+    {
+        int projectedCount = this->projection.size();
+        batch.buffer.resize((size_t)rowCount * projectedCount);
+        for (int rowCounter = 0; rowCounter < rowCount; rowCounter++)
+        {
+            const int *row = cells + (size_t)rowCounter * columnCount;
+            int *projectedRow = batch.buffer.data() + (size_t)rowCounter * projectedCount;
+            for (int columnCounter = 0; columnCounter < projectedCount; columnCounter++)
+                projectedRow[columnCounter] = row[this->projection[columnCounter]];
         }
+        batch.cells = batch.buffer.data();
+        batch.columnCount = projectedCount;
     }
-    return result;
+    batch.rowCount = rowCount;
+    return rowCount;
 }
+
+/**
+ * @brief Restricts the rows returned by getNextBatch to the given columns.
+ *
+ * @param columnIndices indices of the columns to keep, in output order
+ */
+void Cursor::setProjection(const vector<int> &columnIndices)
+{
+    this->projection = columnIndices;
+}
+
 /**
  * @brief Function that loads Page indicated by pageIndex. Now the cursor starts
- * reading from the new page.
+ * reading from the new page and the previous page is unpinned.
  *
  * @param pageIndex 
  */
 void Cursor::nextPage(int pageIndex)
 {
     logger.log("Cursor::nextPage");
-    this->page = bufferManager.getPage(this->tableName, pageIndex);
+    this->page.release();
+    this->page = bufferManager.pinPage(this->table, pageIndex, this->cursorId);
     this->pageIndex = pageIndex;
     this->pagePointer = 0;
 }
\ No newline at end of file
@@ -1,22 +1,58 @@
 #ifndef CURSOR_H
 #define CURSOR_H
 #include"bufferManager.h"
+
+class Table;
+
+/**
+ * @brief A RowBatch is a block of rows stored contiguously in row major order.
+ * Without a projection the cells are those of the page the cursor has pinned,
+ * with a projection only the requested columns are gathered into the batch's
+ * own buffer. Either way the batch is valid until the next call to
+ * Cursor::getNextBatch.
+ *
+ */
+class RowBatch
+{
+public:
+    const int *cells = nullptr;
+    int rowCount = 0;
+    int columnCount = 0;
+    vector<int> buffer;
+
+    RowView getRow(int rowIndex) const
+    {
+        return RowView(this->cells + (size_t)rowIndex * this->columnCount, this->columnCount);
+    }
+};
+
 /**
  * @brief The cursor is an important component of the system. To read from a
  * table, you need to initialize a cursor. The cursor reads rows from a page one
- * at a time.
+ * at a time. The page being read stays pinned in the buffer pool through the
+ * cursor's PageHandle, so rows are read out of the pool without copying the
+ * page. Operators that process many rows should read them a batch at a time
+ * through getNextBatch, which hands out up to a page of rows per call. The
+ * cursor keeps the table it reads from, so it never has to look the table up
+ * in the catalogue and can be used on a worker thread.
  *
  */
 class Cursor{
     public:
-    Page page;
+    PageHandle page;
     int pageIndex;
+    Table *table;
     string tableName;
     int pagePointer;
+    vector<int> projection;
+    int cursorId;
 
     public:
-    Cursor(string tableName, int pageIndex);
+    Cursor(Table *table, int pageIndex);
     vector<int> getNext();
+    RowView getNextRow();
+    int getNextBatch(RowBatch &batch, int maxRowCount);
+    void setProjection(const vector<int> &columnIndices);
     void nextPage(int pageIndex);
 };
 #endif
\ No newline at end of file
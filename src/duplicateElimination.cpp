@@ -0,0 +1,400 @@
+#include "global.h"
+
+/**
+ * @brief Construct a new RowSet:: RowSet object.
+ *
+ * @param columnCount
+ * @param byteBudget memory the set may take up before it reports being full
+ */
+RowSet::RowSet(int columnCount, size_t byteBudget)
+{
+    this->columnCount = columnCount;
+    this->rowLimit = max<size_t>(1, byteBudget / getEntryBytes(columnCount));
+}
+
+/**
+ * @brief Memory a row takes up in a RowSet: its cells and the two slots of
+ * the half full table that point to it.
+ *
+ * @param columnCount
+ * @return size_t
+ */
+size_t RowSet::getEntryBytes(int columnCount)
+{
+    return columnCount * sizeof(int) + 2 * sizeof(uint32_t);
+}
+
+/**
+ * @brief Number of rows to make room for when neededRowCount rows no longer
+ * fit into room for rowCapacity rows. Doubles, but stops at the row limit as
+ * long as the set is not full.
+ *
+ * @param rowCapacity
+ * @param neededRowCount
+ * @return size_t
+ */
+size_t RowSet::getGrownRowCount(size_t rowCapacity, size_t neededRowCount) const
+{
+    size_t rowCount = max<size_t>({neededRowCount, 2 * rowCapacity, 16});
+    if (neededRowCount <= this->rowLimit)
+        rowCount = min(rowCount, this->rowLimit);
+    return rowCount;
+}
+
+/**
+ * @brief Makes room for neededRowCount rows, rebuilding the table of slots if
+ * it would become more than half full.
+ *
+ * @param neededRowCount
+ */
+void RowSet::reserve(size_t neededRowCount)
+{
+    size_t cellRowCapacity = this->cells.capacity() / this->columnCount;
+    if (cellRowCapacity < neededRowCount)
+        this->cells.reserve(this->getGrownRowCount(cellRowCapacity, neededRowCount) * this->columnCount);
+    size_t slotRowCapacity = this->slots.empty() ? 0 : (this->slots.size() - 1) / 2;
+    if (slotRowCapacity >= neededRowCount)
+        return;
+    this->slots.assign(2 * this->getGrownRowCount(slotRowCapacity, neededRowCount) + 1, 0);
+    for (size_t rowCounter = 0; rowCounter < this->rowCount; rowCounter++)
+        this->slots[this->findSlot(this->cells.data() + rowCounter * this->columnCount)] = rowCounter + 1;
+}
+
+/**
+ * @brief Finds the slot holding the row, or the empty slot where it would go.
+ * The table must not be empty.
+ *
+ * @param row
+ * @return size_t
+ */
+size_t RowSet::findSlot(const int *row) const
+{
+    size_t slotCount = this->slots.size();
+    size_t slot = RowHash()(row, this->columnCount) % slotCount;
+    while (this->slots[slot])
+    {
+        const int *storedRow = this->cells.data() + (size_t)(this->slots[slot] - 1) * this->columnCount;
+        if (equal(row, row + this->columnCount, storedRow))
+            break;
+        slot = slot + 1 == slotCount ? 0 : slot + 1;
+    }
+    return slot;
+}
+
+bool RowSet::contains(const int *row) const
+{
+    return !this->slots.empty() && this->slots[this->findSlot(row)];
+}
+
+/**
+ * @brief Adds a copy of the row to the set.
+ *
+ * @param row
+ * @return true if the row was added
+ * @return false if it was in the set already
+ */
+bool RowSet::insert(const int *row)
+{
+    if (this->contains(row))
+        return false;
+    this->reserve(this->rowCount + 1);
+    this->slots[this->findSlot(row)] = this->rowCount + 1;
+    this->cells.insert(this->cells.end(), row, row + this->columnCount);
+    this->rowCount++;
+    return true;
+}
+
+/**
+ * @brief Tells whether the set holds as many rows as fit into its budget.
+ *
+ * @return true if it is full
+ */
+bool RowSet::isFull() const
+{
+    return this->rowCount >= this->rowLimit;
+}
+
+size_t RowSet::size() const
+{
+    return this->rowCount;
+}
+
+/**
+ * @brief Removes all rows and gives the memory they took up back.
+ *
+ */
+void RowSet::clear()
+{
+    this->rowCount = 0;
+    vector<int>().swap(this->cells);
+    vector<uint32_t>().swap(this->slots);
+}
+
+/**
+ * @brief Picks the partition of a row. Every partitioning depth mixes the
+ * row's hash with a different seed, so rows that shared a partition at one
+ * depth are spread over the partitions of the next.
+ *
+ * @param row
+ * @param columnCount
+ * @param depth
+ * @param partitionCount
+ * @return int
+ */
+static int getRowPartition(const int *row, int columnCount, int depth, int partitionCount)
+{
+    uint64_t hash = RowHash()(row, columnCount) ^ ((uint64_t)depth * 0x9e3779b97f4a7c15ULL);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash % partitionCount;
+}
+
+/**
+ * @brief Construct a new HashDistinctOperator:: HashDistinctOperator object.
+ *
+ * @param child
+ * @param name used to name the temporary tables holding the partitions
+ */
+HashDistinctOperator::HashDistinctOperator(unique_ptr<Operator> child, const string &name)
+{
+    logger.log("HashDistinctOperator::HashDistinctOperator");
+    static int distinctCount = 0;
+    this->child = move(child);
+    this->columns = this->child->columns;
+    this->name = name;
+    this->distinctId = distinctCount++;
+}
+
+HashDistinctOperator::~HashDistinctOperator()
+{
+    this->dropPartitions();
+}
+
+/**
+ * @brief Opens one temporary table per partition for the rows that no
+ * longer fit into the hash set, as many as the budget has page buffers for.
+ *
+ */
+void HashDistinctOperator::startSpilling()
+{
+    logger.log("HashDistinctOperator::startSpilling");
+    int partitionCount = max(2, this->getBufferPageCount() - 1);
+    for (int partitionCounter = 0; partitionCounter < partitionCount; partitionCounter++)
+    {
+        string partitionName = "#" + this->name + "_distinct" + to_string(this->distinctId) + "_part" + to_string(this->partitionCounter++);
+        this->spillPartitions.push_back(new Table(partitionName, this->columns));
+        this->spillWriters.emplace_back(make_unique<TableWriter>(this->spillPartitions.back(), false));
+    }
+}
+
+/**
+ * @brief Queues the partitions written while the current input was read and
+ * forgets the rows seen in it.
+ *
+ */
+void HashDistinctOperator::finishInput()
+{
+    logger.log("HashDistinctOperator::finishInput");
+    int depth = this->currentPartition.depth;
+    long long spilledRowCount = 0;
+    for (int partitionCounter = this->spillPartitions.size() - 1; partitionCounter >= 0; partitionCounter--)
+    {
+        Table *table = this->spillPartitions[partitionCounter];
+        this->spillWriters[partitionCounter]->close();
+        tableCatalogue.insertTable(table);
+        spilledRowCount += table->rowCount;
+        Partition partition;
+        partition.table = table;
+        partition.depth = depth + 1;
+        if (table->rowCount)
+            this->pendingPartitions.push_front(partition);
+        else
+            tableCatalogue.deleteTable(table->tableName);
+    }
+    if (!this->spillPartitions.empty())
+        logger.log("HashDistinctOperator::finishInput: " + to_string(spilledRowCount) + " rows into " +
+                   to_string(this->spillPartitions.size()) + " partitions at depth " + to_string(depth));
+    this->spillWriters.clear();
+    this->spillPartitions.clear();
+    this->seenRows.clear();
+    this->input = nullptr;
+}
+
+/**
+ * @brief Starts reading the next partition, or the child the first time
+ * round.
+ *
+ * @return true if there is an input to read
+ * @return false once all partitions have been read
+ */
+bool HashDistinctOperator::startNextPartition()
+{
+    logger.log("HashDistinctOperator::startNextPartition");
+    this->dropCurrentPartition();
+    this->seenRows = RowSet(this->columns.size(), BUFFER_BYTES);
+    if (!this->started)
+    {
+        this->started = true;
+        this->input = this->child.get();
+        return true;
+    }
+    if (this->pendingPartitions.empty())
+        return false;
+    this->currentPartition = this->pendingPartitions.front();
+    this->pendingPartitions.pop_front();
+    this->partitionScan = make_unique<ScanOperator>(this->currentPartition.table);
+    this->input = this->partitionScan.get();
+    return true;
+}
+
+/**
+ * @brief Deletes the temporary table of the partition being read.
+ *
+ */
+void HashDistinctOperator::dropCurrentPartition()
+{
+    this->partitionScan.reset();
+    if (this->currentPartition.table)
+        tableCatalogue.deleteTable(this->currentPartition.table->tableName);
+    this->currentPartition = Partition();
+}
+
+/**
+ * @brief Deletes the temporary tables of all partitions, read or not.
+ *
+ */
+void HashDistinctOperator::dropPartitions()
+{
+    this->dropCurrentPartition();
+    for (Partition &partition : this->pendingPartitions)
+        tableCatalogue.deleteTable(partition.table->tableName);
+    this->pendingPartitions.clear();
+    this->spillWriters.clear();
+    for (Table *table : this->spillPartitions)
+    {
+        table->unload();
+        delete table;
+    }
+    this->spillPartitions.clear();
+}
+
+bool HashDistinctOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("HashDistinctOperator::getNextBatch");
+    int columnCount = this->columns.size();
+    batch.rowCount = 0;
+    batch.columnCount = columnCount;
+    while (true)
+    {
+        if (!this->input && !this->startNextPartition())
+            return false;
+        if (!this->input->getNextBatch(this->inputBatch))
+        {
+            this->finishInput();
+            continue;
+        }
+        batch.buffer.resize((size_t)this->inputBatch.rowCount * columnCount);
+        for (int rowCounter = 0; rowCounter < this->inputBatch.rowCount; rowCounter++)
+        {
+            RowView row = this->inputBatch.getRow(rowCounter);
+            if (!this->spillWriters.empty())
+            {
+                if (this->seenRows.contains(row.begin()))
+                    continue;
+                int partition = getRowPartition(row.begin(), columnCount, this->currentPartition.depth, this->spillWriters.size());
+                this->spillWriters[partition]->writeRow(row);
+                continue;
+            }
+            if (!this->seenRows.insert(row.begin()))
+                continue;
+            copy(row.begin(), row.end(), batch.buffer.begin() + (size_t)batch.rowCount * columnCount);
+            batch.rowCount++;
+            if (this->seenRows.isFull() && this->currentPartition.depth < MAX_PARTITION_DEPTH)
+                this->startSpilling();
+        }
+        if (batch.rowCount)
+        {
+            batch.cells = batch.buffer.data();
+            return true;
+        }
+    }
+}
+
+void HashDistinctOperator::reset()
+{
+    this->dropPartitions();
+    this->child->reset();
+    this->seenRows.clear();
+    this->input = nullptr;
+    this->started = false;
+}
+
+long long HashDistinctOperator::getMaxRowCount() const
+{
+    return this->child->getMaxRowCount();
+}
+
+/**
+ * @brief Construct a new SortDistinctOperator:: SortDistinctOperator object.
+ *
+ * @param child
+ * @param columnIndex column to sort on first
+ * @param name used to name the sort
+ */
+SortDistinctOperator::SortDistinctOperator(unique_ptr<Operator> child, int columnIndex, const string &name)
+{
+    logger.log("SortDistinctOperator::SortDistinctOperator");
+    this->columns = child->columns;
+    int columnCount = this->columns.size();
+    if (columnCount == 1 && child->isSortedOn(0))
+    {
+        this->child = move(child);
+        return;
+    }
+    vector<int> columnIndices = {columnIndex};
+    for (int columnCounter = 0; columnCounter < columnCount; columnCounter++)
+        if (columnCounter != columnIndex)
+            columnIndices.push_back(columnCounter);
+    this->child = make_unique<SortOperator>(move(child), columnIndices, ASC, name);
+}
+
+bool SortDistinctOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("SortDistinctOperator::getNextBatch");
+    batch.rowCount = 0;
+    batch.columnCount = this->columns.size();
+    while (this->child->getNextBatch(this->input))
+    {
+        batch.buffer.resize((size_t)this->input.rowCount * batch.columnCount);
+        for (int rowCounter = 0; rowCounter < this->input.rowCount; rowCounter++)
+        {
+            RowView row = this->input.getRow(rowCounter);
+            if (this->hasPreviousRow && equal(row.begin(), row.end(), this->previousRow.begin()))
+                continue;
+            this->previousRow.assign(row.begin(), row.end());
+            this->hasPreviousRow = true;
+            copy(row.begin(), row.end(), batch.buffer.begin() + (size_t)batch.rowCount * batch.columnCount);
+            batch.rowCount++;
+        }
+        if (batch.rowCount)
+        {
+            batch.cells = batch.buffer.data();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SortDistinctOperator::reset()
+{
+    this->child->reset();
+    this->hasPreviousRow = false;
+}
+
+long long SortDistinctOperator::getMaxRowCount() const
+{
+    return this->child->getMaxRowCount();
+}
@@ -0,0 +1,108 @@
+#ifndef DUPLICATEELIMINATION_H
+#define DUPLICATEELIMINATION_H
+#include "externalSort.h"
+
+/**
+ * @brief A set of rows with a fixed number of columns, stored flat: the rows
+ * lie one after the other in a single buffer and an open addressing table of
+ * row numbers, kept at most half full, finds them by hash. A row therefore
+ * costs its cells plus two slots of the table and nothing else, which is what
+ * getEntryBytes reports, so a set given a byte budget holds exactly as many
+ * rows as fit into it. The storage grows by doubling but not past the budget
+ * until the set is full; rows inserted after that grow it further.
+ *
+ */
+class RowSet
+{
+    int columnCount = 0;
+    size_t rowLimit = 0;
+    size_t rowCount = 0;
+    vector<int> cells;
+    vector<uint32_t> slots;
+
+    size_t getGrownRowCount(size_t rowCapacity, size_t neededRowCount) const;
+    size_t findSlot(const int *row) const;
+    void reserve(size_t neededRowCount);
+
+public:
+    RowSet() {}
+    RowSet(int columnCount, size_t byteBudget);
+    static size_t getEntryBytes(int columnCount);
+    bool contains(const int *row) const;
+    bool insert(const int *row);
+    bool isFull() const;
+    size_t size() const;
+    void clear();
+};
+
+/**
+ * @brief Passes on the first occurrence of every row of its child, keeping
+ * the rows seen so far in a RowSet. Once the set holds as many rows as the
+ * buffer budget has room for it stops growing: rows found in it are still
+ * dropped, but all other rows are written to temporary tables partitioned on
+ * a hash of the whole row. Since equal rows always land in the same
+ * partition, every partition is then deduplicated on its own the same way,
+ * with another hash function should it overflow as well.
+ *
+ */
+class HashDistinctOperator : public Operator
+{
+    static constexpr int MAX_PARTITION_DEPTH = 8;
+
+    struct Partition
+    {
+        Table *table = nullptr;
+        int depth = 0;
+    };
+
+    unique_ptr<Operator> child;
+    string name;
+    int distinctId;
+    int partitionCounter = 0;
+    bool started = false;
+    deque<Partition> pendingPartitions;
+    Partition currentPartition;
+    unique_ptr<Operator> partitionScan;
+    Operator *input = nullptr;
+    RowBatch inputBatch;
+    RowSet seenRows;
+    vector<Table *> spillPartitions;
+    vector<unique_ptr<TableWriter>> spillWriters;
+
+    void startSpilling();
+    void finishInput();
+    bool startNextPartition();
+    void dropCurrentPartition();
+    void dropPartitions();
+
+public:
+    HashDistinctOperator(unique_ptr<Operator> child, const string &name);
+    ~HashDistinctOperator();
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+    long long getMaxRowCount() const;
+};
+
+/**
+ * @brief Passes on the distinct rows of its child by reading them sorted
+ * lexicographically on all columns with an external sort. Equal rows are
+ * then adjacent, so only the last row passed on has to be remembered. The
+ * sort leads with the column with the most distinct values, which settles
+ * most comparisons of the merge on the first column.
+ *
+ */
+class SortDistinctOperator : public Operator
+{
+    unique_ptr<Operator> child;
+    RowBatch input;
+    bool hasPreviousRow = false;
+    vector<int> previousRow;
+
+public:
+    SortDistinctOperator(unique_ptr<Operator> child, int columnIndex, const string &name);
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+    long long getMaxRowCount() const;
+};
+
+#endif
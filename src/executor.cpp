@@ -16,7 +16,9 @@ void executeCommand(){
         case PROJECTION: executePROJECTION(); break;
         case RENAME: executeRENAME(); break;
         case SELECTION: executeSELECTION(); break;
+        case SET: executeSET(); break;
         case SORT: executeSORT(); break;
+        case STATS: executeSTATS(); break;
         case SOURCE: executeSOURCE(); break;
         case PATHQUERY: executePATH(); break;
         default: cout<<"PARSING ERROR"<<endl;
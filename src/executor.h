@@ -1,6 +1,9 @@
 #ifndef EXECUTOR_H
 #define EXECUTOR_H
-#include"semanticParser.h"
+#include"externalSort.h"
+#include"hashJoin.h"
+#include"sortMergeJoin.h"
+#include"duplicateElimination.h"
 
 void executeCommand();
 
@@ -17,10 +20,19 @@ void executePRINT();
 void executePROJECTION();
 void executeRENAME();
 void executeSELECTION();
+void executeSET();
 void executeSORT();
+void executeSTATS();
 void executeSOURCE();
 void executePATH();
 
+unique_ptr<Operator> buildCROSS(const ParsedQuery &query);
+unique_ptr<Operator> buildDISTINCT(const ParsedQuery &query);
+unique_ptr<Operator> buildJOIN(const ParsedQuery &query);
+unique_ptr<Operator> buildPROJECTION(const ParsedQuery &query);
+unique_ptr<Operator> buildSELECTION(const ParsedQuery &query);
+unique_ptr<Operator> buildSORT(const ParsedQuery &query);
+
 bool evaluateBinOp(int value1, int value2, BinaryOperator binaryOperator);
 void printRowCount(int rowCount);
 #endif
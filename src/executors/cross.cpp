@@ -29,7 +29,7 @@ bool semanticParseCROSS()
         return false;
     }
 
-    if (!tableCatalogue.isTable(parsedQuery.crossFirstRelationName) || !tableCatalogue.isTable(parsedQuery.crossSecondRelationName))
+    if (!isRelation(parsedQuery, parsedQuery.crossFirstRelationName) || !isRelation(parsedQuery, parsedQuery.crossSecondRelationName))
     {
         cout << "SEMANTIC ERROR: Cross relations don't exist" << endl;
         return false;
@@ -37,67 +37,21 @@ bool semanticParseCROSS()
     return true;
 }
 
+unique_ptr<Operator> buildCROSS(const ParsedQuery &query)
+{
+    logger.log("buildCROSS");
+    unique_ptr<Operator> left = buildRelationOperator(query, query.crossFirstRelationName);
+    unique_ptr<Operator> right = buildRelationOperator(query, query.crossSecondRelationName);
+    vector<string> columns = getCrossColumns(left->columns, right->columns, query.crossFirstRelationName, query.crossSecondRelationName);
+    return make_unique<BlockNestedLoopJoinOperator>(move(left), move(right), columns);
+}
+
 void executeCROSS()
 {
     logger.log("executeCROSS");
-
-    Table table1 = *(tableCatalogue.getTable(parsedQuery.crossFirstRelationName));
-    Table table2 = *(tableCatalogue.getTable(parsedQuery.crossSecondRelationName));
-
-    vector<string> columns;
-
-    //If both tables are the same i.e. CROSS a a, then names are indexed as a1 and a2
-    if(table1.tableName == table2.tableName){
-        parsedQuery.crossFirstRelationName += "1";
-        parsedQuery.crossSecondRelationName += "2";
-    }
-
-    //Creating list of column names
-    for (int columnCounter = 0; columnCounter < table1.columnCount; columnCounter++)
-    {
-        string columnName = table1.columns[columnCounter];
-        if (table2.isColumn(columnName))
-        {
-            columnName = parsedQuery.crossFirstRelationName + "_" + columnName;
-        }
-        columns.emplace_back(columnName);
-    }
-
-    for (int columnCounter = 0; columnCounter < table2.columnCount; columnCounter++)
-    {
-        string columnName = table2.columns[columnCounter];
-        if (table1.isColumn(columnName))
-        {
-            columnName = parsedQuery.crossSecondRelationName + "_" + columnName;
-        }
-        columns.emplace_back(columnName);
-    }
-
-    Table *resultantTable = new Table(parsedQuery.crossResultRelationName, columns);\
-
-    Cursor cursor1 = table1.getCursor();
-    Cursor cursor2 = table2.getCursor();
-
-    vector<int> row1 = cursor1.getNext();
-    vector<int> row2;
-    vector<int> resultantRow;
-    resultantRow.reserve(resultantTable->columnCount);
-
-    while (!row1.empty())
-    {
-
-        cursor2 = table2.getCursor();
-        row2 = cursor2.getNext();
-        while (!row2.empty())
-        {
-            resultantRow = row1;
-            resultantRow.insert(resultantRow.end(), row2.begin(), row2.end());
-            resultantTable->writeRow<int>(resultantRow);
-            row2 = cursor2.getNext();
-        }
-        row1 = cursor1.getNext();
-    }
-    resultantTable->blockify();
+    unique_ptr<Operator> root = buildCROSS(parsedQuery);
+    Table *resultantTable = new Table(parsedQuery.crossResultRelationName, root->columns);
+    executeOperator(*root, resultantTable);
     tableCatalogue.insertTable(resultantTable);
     return;
 }
\ No newline at end of file
@@ -28,7 +28,7 @@ bool semanticParseDISTINCT()
         return false;
     }
 
-    if (!tableCatalogue.isTable(parsedQuery.distinctRelationName))
+    if (!isRelation(parsedQuery, parsedQuery.distinctRelationName))
     {
         cout << "SEMANTIC ERROR: Relation doesn't exist" << endl;
         return false;
@@ -36,8 +36,57 @@ bool semanticParseDISTINCT()
     return true;
 }
 
+/**
+ * @brief Plans the duplicate elimination of a relation from the statistics
+ * of its columns. A relation with a column whose values are known to be all
+ * different has no duplicate rows, so its rows are passed on as they are.
+ * Otherwise the number of distinct rows is bounded by the product of the
+ * columns' distinct value counts: when that many rows fit into the buffer
+ * budget they are found with a hash set, when they do not the rows are
+ * sorted on all columns, leading with the column with the most distinct
+ * values, instead of spilling most of them from a hash set. Nested queries
+ * have no statistics and are always deduplicated with a hash set.
+ *
+ * @param query 
+ * @return unique_ptr<Operator> 
+ */
+unique_ptr<Operator> buildDISTINCT(const ParsedQuery &query)
+{
+    logger.log("buildDISTINCT");
+    unique_ptr<Operator> source = buildRelationOperator(query, query.distinctRelationName);
+    Table *table = findSubquery(query, query.distinctRelationName) ? nullptr : tableCatalogue.getTable(query.distinctRelationName);
+    if (!table || table->columnStatistics.size() != table->columnCount)
+        return make_unique<HashDistinctOperator>(move(source), query.distinctResultRelationName);
+
+    int keyColumnIndex = 0;
+    long long distinctRowCount = 1;
+    for (int columnCounter = 0; columnCounter < table->columnCount; columnCounter++)
+    {
+        uint distinctCount = table->distinctValuesPerColumnCount[columnCounter];
+        if (table->columnStatistics[columnCounter].isDistinctCountExact() && distinctCount == table->rowCount)
+        {
+            logger.log("buildDISTINCT: " + table->columns[columnCounter] + " is unique, rows passed on as they are");
+            return source;
+        }
+        if (distinctCount > table->distinctValuesPerColumnCount[keyColumnIndex])
+            keyColumnIndex = columnCounter;
+        distinctRowCount = min<long long>(table->rowCount, distinctRowCount * max(1u, distinctCount));
+    }
+    if (distinctRowCount * RowSet::getEntryBytes(table->columnCount) <= BUFFER_BYTES)
+    {
+        logger.log("buildDISTINCT: hashing at most " + to_string(distinctRowCount) + " distinct rows");
+        return make_unique<HashDistinctOperator>(move(source), query.distinctResultRelationName);
+    }
+    logger.log("buildDISTINCT: sorting on " + table->columns[keyColumnIndex]);
+    return make_unique<SortDistinctOperator>(move(source), keyColumnIndex, query.distinctResultRelationName);
+}
+
 void executeDISTINCT()
 {
     logger.log("executeDISTINCT");
+    unique_ptr<Operator> root = buildDISTINCT(parsedQuery);
+    Table *resultantTable = new Table(parsedQuery.distinctResultRelationName, root->columns);
+    executeOperator(*root, resultantTable);
+    tableCatalogue.insertTable(resultantTable);
     return;
 }
\ No newline at end of file
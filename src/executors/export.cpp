@@ -58,15 +58,23 @@ void writeRow(const vector<string> &row, ostream &out)
     out << endl;
 }
 
-void writeRow(const vector<int> &row, ostream &out)
+void writeRows(Cursor &cursor, ostream &out)
 {
-    for (size_t i = 0; i < row.size(); i++)
+    RowBatch batch;
+    while (cursor.getNextBatch(batch, INT_MAX))
     {
-        if (i > 0)
-            out << ",";
-        out << row[i];
+        for (int rowCounter = 0; rowCounter < batch.rowCount; rowCounter++)
+        {
+            RowView row = batch.getRow(rowCounter);
+            for (int i = 0; i < row.size(); i++)
+            {
+                if (i > 0)
+                    out << ",";
+                out << row[i];
+            }
+            out << "\n";
+        }
     }
-    out << endl;
 }
 
 void executeEXPORT()
@@ -83,29 +91,18 @@ void executeEXPORT()
 
         string nodesFile = "../data/" + graph->nodesTable.tableName + ".csv";
         ofstream nodesOut(nodesFile, ios::out);
+        ioStatistics.recordFileOpen(graph->nodesTable.tableName);
         writeRow(graph->nodesTable.columns, nodesOut);
         Cursor nodeCursor = graph->nodesTable.getCursor();
-        vector<int> row;
-        for (long long i = 0; i < graph->nodesTable.rowCount; i++)
-        {
-            row = nodeCursor.getNext();
-            if (row.empty())
-                break;
-            writeRow(row, nodesOut);
-        }
+        writeRows(nodeCursor, nodesOut);
         nodesOut.close();
 
         string edgesFile = "../data/" + graph->edgesTable.tableName + ".csv";
         ofstream edgesOut(edgesFile, ios::out);
+        ioStatistics.recordFileOpen(graph->edgesTable.tableName);
         writeRow(graph->edgesTable.columns, edgesOut);
         Cursor edgeCursor = graph->edgesTable.getCursor();
-        for (long long i = 0; i < graph->edgesTable.rowCount; i++)
-        {
-            row = edgeCursor.getNext();
-            if (row.empty())
-                break;
-            writeRow(row, edgesOut);
-        }
+        writeRows(edgeCursor, edgesOut);
         edgesOut.close();
         return;
     }
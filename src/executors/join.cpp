@@ -49,13 +49,13 @@ bool semanticParseJOIN()
         return false;
     }
 
-    if (!tableCatalogue.isTable(parsedQuery.joinFirstRelationName) || !tableCatalogue.isTable(parsedQuery.joinSecondRelationName))
+    if (!isRelation(parsedQuery, parsedQuery.joinFirstRelationName) || !isRelation(parsedQuery, parsedQuery.joinSecondRelationName))
     {
         cout << "SEMANTIC ERROR: Relation doesn't exist" << endl;
         return false;
     }
 
-    if (!tableCatalogue.isColumnFromTable(parsedQuery.joinFirstColumnName, parsedQuery.joinFirstRelationName) || !tableCatalogue.isColumnFromTable(parsedQuery.joinSecondColumnName, parsedQuery.joinSecondRelationName))
+    if (!isColumnFromRelation(parsedQuery, parsedQuery.joinFirstColumnName, parsedQuery.joinFirstRelationName) || !isColumnFromRelation(parsedQuery, parsedQuery.joinSecondColumnName, parsedQuery.joinSecondRelationName))
     {
         cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
         return false;
@@ -63,8 +63,51 @@ bool semanticParseJOIN()
     return true;
 }
 
+/**
+ * @brief Builds the operators of a join. The result has the columns of a
+ * CROSS of the two relations and holds the pairs of rows satisfying the
+ * condition. Equi-joins are hash joins that build on the relation with fewer
+ * rows, a nested query counting as larger than any relation. <, <=, > and >=
+ * are sort-merge joins and != is evaluated for every pair of rows.
+ *
+ * @param query 
+ * @return unique_ptr<Operator> 
+ */
+unique_ptr<Operator> buildJOIN(const ParsedQuery &query)
+{
+    logger.log("buildJOIN");
+    unique_ptr<Operator> left = buildRelationOperator(query, query.joinFirstRelationName);
+    unique_ptr<Operator> right = buildRelationOperator(query, query.joinSecondRelationName);
+    int leftColumnIndex = left->getColumnIndex(query.joinFirstColumnName);
+    int rightColumnIndex = right->getColumnIndex(query.joinSecondColumnName);
+    vector<string> columns = getCrossColumns(left->columns, right->columns, query.joinFirstRelationName, query.joinSecondRelationName);
+    if (query.joinBinaryOperator == EQUAL)
+    {
+        long long leftRowCount = left->getMaxRowCount();
+        long long rightRowCount = right->getMaxRowCount();
+        bool buildLeft = leftRowCount != -1 && (rightRowCount == -1 || leftRowCount < rightRowCount);
+        return make_unique<HashJoinOperator>(move(left), move(right), columns, leftColumnIndex, rightColumnIndex,
+                                             buildLeft, query.joinResultRelationName);
+    }
+    if (query.joinBinaryOperator != NOT_EQUAL)
+        return make_unique<SortMergeJoinOperator>(move(left), move(right), columns, leftColumnIndex,
+                                                  query.joinBinaryOperator, rightColumnIndex, query.joinResultRelationName);
+    return make_unique<BlockNestedLoopJoinOperator>(move(left), move(right), columns,
+                                                    leftColumnIndex, query.joinBinaryOperator, rightColumnIndex);
+}
+
 void executeJOIN()
 {
     logger.log("executeJOIN");
+    unique_ptr<Operator> root = buildJOIN(parsedQuery);
+    Table *resultantTable = new Table(parsedQuery.joinResultRelationName, root->columns);
+    if (executeOperator(*root, resultantTable))
+        tableCatalogue.insertTable(resultantTable);
+    else
+    {
+        cout << "Empty Table" << endl;
+        resultantTable->unload();
+        delete resultantTable;
+    }
     return;
 }
\ No newline at end of file
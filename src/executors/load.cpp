@@ -2,11 +2,24 @@
 /**
  * @brief
  * SYNTAX: LOAD relation_name
+ *         LOAD relation_name BLOCKSIZE block_size_in_kb
+ *         LOAD GRAPH graph_name U|D
  */
 bool syntacticParseLOAD()
 {
     logger.log("syntacticParseLOAD");
     // cout << tokenizedQuery[0];
+    if (tokenizedQuery.size() == 4 && tokenizedQuery[2] == "BLOCKSIZE")
+    {
+        parsedQuery.queryType = LOAD;
+        parsedQuery.loadRelationName = tokenizedQuery[1];
+        if (!parseBlockSize(tokenizedQuery[3], parsedQuery.loadBlockSize))
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return false;
+        }
+        return true;
+    }
     if (tokenizedQuery.size() != 2)
     {
         if (tokenizedQuery.size() != 4 || tokenizedQuery[1] != "GRAPH" || (tokenizedQuery[3] != "U" && tokenizedQuery[3] != "D"))
@@ -65,7 +78,7 @@ void executeLOAD()
         }
         return;
     }
-    Table *table = new Table(parsedQuery.loadRelationName);
+    Table *table = new Table(parsedQuery.loadRelationName, parsedQuery.loadBlockSize ? parsedQuery.loadBlockSize : BLOCK_SIZE);
     if (table->load())
     {
         tableCatalogue.insertTable(table);
@@ -29,16 +29,15 @@ bool semanticParsePROJECTION()
         return false;
     }
 
-    if (!tableCatalogue.isTable(parsedQuery.projectionRelationName))
+    if (!isRelation(parsedQuery, parsedQuery.projectionRelationName))
     {
         cout << "SEMANTIC ERROR: Relation doesn't exist" << endl;
         return false;
     }
 
-    Table table = *tableCatalogue.getTable(parsedQuery.projectionRelationName);
     for (auto col : parsedQuery.projectionColumnList)
     {
-        if (!table.isColumn(col))
+        if (!isColumnFromRelation(parsedQuery, col, parsedQuery.projectionRelationName))
         {
             cout << "SEMANTIC ERROR: Column doesn't exist in relation";
             return false;
@@ -47,31 +46,36 @@ bool semanticParsePROJECTION()
     return true;
 }
 
-void executePROJECTION()
+/**
+ * @brief Builds the operators of a projection. A projection of a table is
+ * done by the cursor reading the table.
+ *
+ * @param query 
+ * @return unique_ptr<Operator> 
+ */
+unique_ptr<Operator> buildPROJECTION(const ParsedQuery &query)
 {
-    logger.log("executePROJECTION");
-    Table* resultantTable = new Table(parsedQuery.projectionResultRelationName, parsedQuery.projectionColumnList);
-    Table table = *tableCatalogue.getTable(parsedQuery.projectionRelationName);
-    Cursor cursor = table.getCursor();
+    logger.log("buildPROJECTION");
+    unique_ptr<Operator> source = buildRelationOperator(query, query.projectionRelationName);
     vector<int> columnIndices;
-    for (int columnCounter = 0; columnCounter < parsedQuery.projectionColumnList.size(); columnCounter++)
+    for (int columnCounter = 0; columnCounter < query.projectionColumnList.size(); columnCounter++)
     {
-        columnIndices.emplace_back(table.getColumnIndex(parsedQuery.projectionColumnList[columnCounter]));
+        columnIndices.emplace_back(source->getColumnIndex(query.projectionColumnList[columnCounter]));
     }
-    vector<int> row = cursor.getNext();
-    vector<int> resultantRow(columnIndices.size(), 0);
-
-    while (!row.empty())
+    if (!findSubquery(query, query.projectionRelationName))
     {
-
-        for (int columnCounter = 0; columnCounter < columnIndices.size(); columnCounter++)
-        {
-            resultantRow[columnCounter] = row[columnIndices[columnCounter]];
-        }
-        resultantTable->writeRow<int>(resultantRow);
-        row = cursor.getNext();
+        static_cast<ScanOperator *>(source.get())->setProjection(columnIndices);
+        return source;
     }
-    resultantTable->blockify();
+    return make_unique<ProjectOperator>(move(source), columnIndices);
+}
+
+void executePROJECTION()
+{
+    logger.log("executePROJECTION");
+    unique_ptr<Operator> root = buildPROJECTION(parsedQuery);
+    Table* resultantTable = new Table(parsedQuery.projectionResultRelationName, parsedQuery.projectionColumnList);
+    executeOperator(*root, resultantTable);
     tableCatalogue.insertTable(resultantTable);
     return;
 }
\ No newline at end of file
@@ -59,13 +59,13 @@ bool semanticParseSELECTION()
         return false;
     }
 
-    if (!tableCatalogue.isTable(parsedQuery.selectionRelationName))
+    if (!isRelation(parsedQuery, parsedQuery.selectionRelationName))
     {
         cout << "SEMANTIC ERROR: Relation doesn't exist" << endl;
         return false;
     }
 
-    if (!tableCatalogue.isColumnFromTable(parsedQuery.selectionFirstColumnName, parsedQuery.selectionRelationName))
+    if (!isColumnFromRelation(parsedQuery, parsedQuery.selectionFirstColumnName, parsedQuery.selectionRelationName))
     {
         cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
         return false;
@@ -73,7 +73,7 @@ bool semanticParseSELECTION()
 
     if (parsedQuery.selectType == COLUMN)
     {
-        if (!tableCatalogue.isColumnFromTable(parsedQuery.selectionSecondColumnName, parsedQuery.selectionRelationName))
+        if (!isColumnFromRelation(parsedQuery, parsedQuery.selectionSecondColumnName, parsedQuery.selectionRelationName))
         {
             cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
             return false;
@@ -103,32 +103,99 @@ bool evaluateBinOp(int value1, int value2, BinaryOperator binaryOperator)
     }
 }
 
-void executeSELECTION()
+/**
+ * @brief Tells whether value1 binaryOperator value2 can hold for any value1 in
+ * [minValue1, maxValue1] and any value2 in [minValue2, maxValue2].
+ *
+ * @return true if some pair of values may satisfy the comparison
+ * @return false if none can
+ */
+static bool rangesMayMatch(int minValue1, int maxValue1, int minValue2, int maxValue2, BinaryOperator binaryOperator)
 {
-    logger.log("executeSELECTION");
-
-    Table table = *tableCatalogue.getTable(parsedQuery.selectionRelationName);
-    Table* resultantTable = new Table(parsedQuery.selectionResultRelationName, table.columns);
-    Cursor cursor = table.getCursor();
-    vector<int> row = cursor.getNext();
-    int firstColumnIndex = table.getColumnIndex(parsedQuery.selectionFirstColumnName);
-    int secondColumnIndex;
-    if (parsedQuery.selectType == COLUMN)
-        secondColumnIndex = table.getColumnIndex(parsedQuery.selectionSecondColumnName);
-    while (!row.empty())
+    switch (binaryOperator)
     {
+    case LESS_THAN:
+    case LEQ:
+        return evaluateBinOp(minValue1, maxValue2, binaryOperator);
+    case GREATER_THAN:
+    case GEQ:
+        return evaluateBinOp(maxValue1, minValue2, binaryOperator);
+    case EQUAL:
+        return minValue1 <= maxValue2 && minValue2 <= maxValue1;
+    case NOT_EQUAL:
+        return !(minValue1 == maxValue1 && minValue2 == maxValue2 && minValue1 == minValue2);
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief Uses the zone map of a page to decide whether the page can hold a
+ * row satisfying the selection condition. Pages without a zone map are
+ * always read.
+ *
+ * @param query 
+ * @param table 
+ * @param pageIndex 
+ * @param firstColumnIndex 
+ * @param secondColumnIndex only used when comparing two columns
+ * @return true if the page has to be read
+ * @return false if the page can be skipped
+ */
+static bool pageMayMatch(const ParsedQuery &query, Table *table, int pageIndex, int firstColumnIndex, int secondColumnIndex)
+{
+    int minValue1, maxValue1, minValue2, maxValue2;
+    if (!table->getPageValueRange(pageIndex, firstColumnIndex, minValue1, maxValue1))
+        return true;
+    if (query.selectType == INT_LITERAL)
+        minValue2 = maxValue2 = query.selectionIntLiteral;
+    else if (!table->getPageValueRange(pageIndex, secondColumnIndex, minValue2, maxValue2))
+        return true;
+    return rangesMayMatch(minValue1, maxValue1, minValue2, maxValue2, query.selectionBinaryOperator);
+}
 
-        int value1 = row[firstColumnIndex];
-        int value2;
-        if (parsedQuery.selectType == INT_LITERAL)
-            value2 = parsedQuery.selectionIntLiteral;
-        else
-            value2 = row[secondColumnIndex];
-        if (evaluateBinOp(value1, value2, parsedQuery.selectionBinaryOperator))
-            resultantTable->writeRow<int>(row);
-        row = cursor.getNext();
+/**
+ * @brief Builds the operators of a selection. When the rows come straight
+ * from a table, pages whose zone maps show that none of their rows can
+ * satisfy the condition are skipped without being read.
+ *
+ * @param query 
+ * @return unique_ptr<Operator> 
+ */
+unique_ptr<Operator> buildSELECTION(const ParsedQuery &query)
+{
+    logger.log("buildSELECTION");
+    vector<string> columns = getRelationColumns(query, query.selectionRelationName);
+    int firstColumnIndex = find(columns.begin(), columns.end(), query.selectionFirstColumnName) - columns.begin();
+    int secondColumnIndex = -1;
+    if (query.selectType == COLUMN)
+        secondColumnIndex = find(columns.begin(), columns.end(), query.selectionSecondColumnName) - columns.begin();
+
+    unique_ptr<Operator> source;
+    if (!findSubquery(query, query.selectionRelationName))
+    {
+        Table *table = tableCatalogue.getTable(query.selectionRelationName);
+        vector<int> pageIndices;
+        for (int pageIndex = 0; pageIndex < table->blockCount; pageIndex++)
+            if (pageMayMatch(query, table, pageIndex, firstColumnIndex, secondColumnIndex))
+                pageIndices.push_back(pageIndex);
+        logger.log("buildSELECTION: reading " + to_string(pageIndices.size()) + " of " +
+                   to_string(table->blockCount) + " pages");
+        source = make_unique<ScanOperator>(table, pageIndices);
     }
-    if(resultantTable->blockify())
+    else
+        source = buildRelationOperator(query, query.selectionRelationName);
+    return make_unique<SelectOperator>(move(source), firstColumnIndex, query.selectionBinaryOperator,
+                                       secondColumnIndex, query.selectionIntLiteral);
+}
+
+void executeSELECTION()
+{
+    logger.log("executeSELECTION");
+
+    unique_ptr<Operator> root = buildSELECTION(parsedQuery);
+    Table* resultantTable = new Table(parsedQuery.selectionResultRelationName, root->columns);
+    if(executeOperator(*root, resultantTable))
         tableCatalogue.insertTable(resultantTable);
     else{
         cout<<"Empty Table"<<endl;
@@ -136,4 +203,4 @@ void executeSELECTION()
         delete resultantTable;
     }
     return;
-}
\ No newline at end of file
+}
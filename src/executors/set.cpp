@@ -0,0 +1,58 @@
+#include "global.h"
+/**
+ * @brief 
+ * SYNTAX: SET BUFFER byte_count
+ *         SET BUFFER POLICY FIFO|LRU|CLOCK|2Q
+ *         SET BLOCKSIZE block_size_in_kb
+ *
+ * byte_count may end in K, M or G. A new block size applies to tables created
+ * afterwards, tables that exist keep the block size they were written with.
+ */
+bool syntacticParseSET()
+{
+    logger.log("syntacticParseSET");
+    parsedQuery.queryType = SET;
+    if (tokenizedQuery.size() == 4 && tokenizedQuery[1] == "BUFFER" && tokenizedQuery[2] == "POLICY")
+    {
+        parsedQuery.setParameterName = "POLICY";
+        if (parseReplacementStrategy(tokenizedQuery[3], parsedQuery.setReplacementStrategy))
+            return true;
+    }
+    else if (tokenizedQuery.size() == 3 && tokenizedQuery[1] == "BUFFER")
+    {
+        parsedQuery.setParameterName = "BUFFER";
+        if (parseByteCount(tokenizedQuery[2], parsedQuery.setBufferBytes))
+            return true;
+    }
+    else if (tokenizedQuery.size() == 3 && tokenizedQuery[1] == "BLOCKSIZE")
+    {
+        parsedQuery.setParameterName = "BLOCKSIZE";
+        if (parseBlockSize(tokenizedQuery[2], parsedQuery.setBlockSize))
+            return true;
+    }
+    cout << "SYNTAX ERROR" << endl;
+    return false;
+}
+
+bool semanticParseSET()
+{
+    logger.log("semanticParseSET");
+    return true;
+}
+
+void executeSET()
+{
+    logger.log("executeSET");
+    if (parsedQuery.setParameterName == "POLICY")
+    {
+        bufferManager.setReplacementPolicy(parsedQuery.setReplacementStrategy);
+        cout << "Buffer policy: " << bufferManager.getReplacementPolicyName() << endl;
+        return;
+    }
+    if (parsedQuery.setParameterName == "BLOCKSIZE")
+        BLOCK_SIZE = parsedQuery.setBlockSize;
+    else
+        BUFFER_BYTES = parsedQuery.setBufferBytes;
+    bufferManager.setBufferBytes(BUFFER_BYTES);
+    cout << "Buffer: " << BUFFER_BYTES << " bytes, Block size: " << BLOCK_SIZE << " KB, Block count: " << BLOCK_COUNT << endl;
+}
@@ -37,12 +37,12 @@ bool semanticParseSORT(){
         return false;
     }
 
-    if(!tableCatalogue.isTable(parsedQuery.sortRelationName)){
+    if(!isRelation(parsedQuery, parsedQuery.sortRelationName)){
         cout<<"SEMANTIC ERROR: Relation doesn't exist"<<endl;
         return false;
     }
 
-    if(!tableCatalogue.isColumnFromTable(parsedQuery.sortColumnName, parsedQuery.sortRelationName)){
+    if(!isColumnFromRelation(parsedQuery, parsedQuery.sortColumnName, parsedQuery.sortRelationName)){
         cout<<"SEMANTIC ERROR: Column doesn't exist in relation"<<endl;
         return false;
     }
@@ -50,7 +50,31 @@ bool semanticParseSORT(){
     return true;
 }
 
+/**
+ * @brief Builds the external merge sort of a relation. The sort reads all of
+ * its input before handing out the first row, so its runs are the only
+ * intermediate data of a query that is written to disk. Input known to be
+ * sorted in ascending order already is passed on as it is.
+ * 
+ * @param query 
+ * @return unique_ptr<Operator> 
+ */
+unique_ptr<Operator> buildSORT(const ParsedQuery &query){
+    logger.log("buildSORT");
+    unique_ptr<Operator> source = buildRelationOperator(query, query.sortRelationName);
+    int columnIndex = source->getColumnIndex(query.sortColumnName);
+    if (query.sortingStrategy == ASC && source->isSortedOn(columnIndex))
+        return source;
+    return make_unique<SortOperator>(move(source), columnIndex, query.sortingStrategy, query.sortResultRelationName);
+}
+
 void executeSORT(){
     logger.log("executeSORT");
+    unique_ptr<Operator> root = buildSORT(parsedQuery);
+    Table *resultantTable = new Table(parsedQuery.sortResultRelationName, root->columns);
+    executeOperator(*root, resultantTable);
+    resultantTable->sortedColumn = parsedQuery.sortColumnName;
+    resultantTable->sortedDescending = parsedQuery.sortingStrategy == DESC;
+    tableCatalogue.insertTable(resultantTable);
     return;
-}
\ No newline at end of file
+}
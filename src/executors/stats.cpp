@@ -0,0 +1,36 @@
+#include "global.h"
+/**
+ * @brief 
+ * SYNTAX: STATS
+ *         STATS RESET
+ */
+bool syntacticParseSTATS()
+{
+    logger.log("syntacticParseSTATS");
+    if (tokenizedQuery.size() > 2 || (tokenizedQuery.size() == 2 && tokenizedQuery[1] != "RESET"))
+    {
+        cout << "SYNTAX ERROR" << endl;
+        return false;
+    }
+    parsedQuery.queryType = STATS;
+    parsedQuery.statsReset = tokenizedQuery.size() == 2;
+    return true;
+}
+
+bool semanticParseSTATS()
+{
+    logger.log("semanticParseSTATS");
+    return true;
+}
+
+void executeSTATS()
+{
+    logger.log("executeSTATS");
+    if (parsedQuery.statsReset)
+    {
+        ioStatistics.reset();
+        cout << "Statistics reset" << endl;
+        return;
+    }
+    ioStatistics.print(cout);
+}
@@ -0,0 +1,562 @@
+#include "global.h"
+
+LoserTree::LoserTree(int leafCount, const vector<int> &columnIndices, bool descending)
+{
+    this->losers.assign(max(1, leafCount), 0);
+    this->keys.assign(leafCount, nullptr);
+    this->exhausted.assign(leafCount, false);
+    this->columnIndices = columnIndices;
+    this->descending = descending;
+}
+
+/**
+ * @brief Decides the match between two leaves.
+ *
+ * @param leaf1
+ * @param leaf2
+ * @return true if leaf1 wins
+ * @return false if leaf2 wins
+ */
+bool LoserTree::beats(int leaf1, int leaf2) const
+{
+    if (this->exhausted[leaf1] || this->exhausted[leaf2])
+        return !this->exhausted[leaf1] || (this->exhausted[leaf2] && leaf1 < leaf2);
+    for (int columnIndex : this->columnIndices)
+    {
+        int key1 = this->keys[leaf1][columnIndex];
+        int key2 = this->keys[leaf2][columnIndex];
+        if (key1 != key2)
+            return this->descending ? key1 > key2 : key1 < key2;
+    }
+    return leaf1 < leaf2;
+}
+
+/**
+ * @brief Sets the current row of a leaf. The row is not copied, it has to
+ * stay valid until the leaf's key is set again or the leaf is exhausted.
+ *
+ * @param leaf
+ * @param row
+ */
+void LoserTree::setKey(int leaf, const int *row)
+{
+    this->keys[leaf] = row;
+    this->exhausted[leaf] = false;
+}
+
+void LoserTree::setExhausted(int leaf)
+{
+    this->exhausted[leaf] = true;
+}
+
+/**
+ * @brief Plays all matches once the first key of every leaf has been set.
+ * Leaf i sits at node leafCount + i and the children of node n are 2n and
+ * 2n + 1.
+ *
+ */
+void LoserTree::build()
+{
+    int leafCount = this->keys.size();
+    if (leafCount == 0)
+        return;
+    vector<int> winners(2 * leafCount);
+    for (int leaf = 0; leaf < leafCount; leaf++)
+        winners[leafCount + leaf] = leaf;
+    for (int node = leafCount - 1; node >= 1; node--)
+    {
+        int leaf1 = winners[2 * node];
+        int leaf2 = winners[2 * node + 1];
+        bool firstWins = this->beats(leaf1, leaf2);
+        winners[node] = firstWins ? leaf1 : leaf2;
+        this->losers[node] = firstWins ? leaf2 : leaf1;
+    }
+    this->losers[0] = leafCount == 1 ? 0 : winners[1];
+}
+
+/**
+ * @brief Leaf holding the smallest key (largest when descending).
+ *
+ * @return int -1 once every leaf is exhausted
+ */
+int LoserTree::getWinner() const
+{
+    if (this->keys.empty() || this->exhausted[this->losers[0]])
+        return -1;
+    return this->losers[0];
+}
+
+/**
+ * @brief Replays the matches from a leaf whose key has changed up to the root.
+ *
+ * @param leaf
+ */
+void LoserTree::replay(int leaf)
+{
+    int leafCount = this->keys.size();
+    int winner = leaf;
+    for (int node = (leafCount + leaf) / 2; node >= 1; node /= 2)
+        if (this->beats(this->losers[node], winner))
+            swap(this->losers[node], winner);
+    this->losers[0] = winner;
+}
+
+MergeOperator::MergeOperator(vector<unique_ptr<Operator>> inputs, const vector<int> &columnIndices, SortingStrategy sortingStrategy)
+{
+    logger.log("MergeOperator::MergeOperator");
+    this->inputs = move(inputs);
+    this->columns = this->inputs.front()->columns;
+    this->columnIndices = columnIndices;
+    this->sortingStrategy = sortingStrategy;
+    this->start();
+}
+
+/**
+ * @brief Reads the first batch of every input and plays the first round.
+ *
+ */
+void MergeOperator::start()
+{
+    int inputCount = this->inputs.size();
+    this->inputBatches.assign(inputCount, RowBatch());
+    this->inputRows.assign(inputCount, 0);
+    this->tree = LoserTree(inputCount, this->columnIndices, this->sortingStrategy == DESC);
+    for (int inputIndex = 0; inputIndex < inputCount; inputIndex++)
+    {
+        if (this->inputs[inputIndex]->getNextBatch(this->inputBatches[inputIndex]))
+            this->tree.setKey(inputIndex, this->inputBatches[inputIndex].getRow(0).begin());
+        else
+            this->tree.setExhausted(inputIndex);
+    }
+    this->tree.build();
+}
+
+/**
+ * @brief Moves an input on to its next row, reading its next batch when the
+ * current one is used up, and replays its matches.
+ *
+ * @param inputIndex
+ */
+void MergeOperator::advance(int inputIndex)
+{
+    RowBatch &inputBatch = this->inputBatches[inputIndex];
+    if (++this->inputRows[inputIndex] >= inputBatch.rowCount)
+    {
+        this->inputRows[inputIndex] = 0;
+        if (!this->inputs[inputIndex]->getNextBatch(inputBatch))
+        {
+            this->tree.setExhausted(inputIndex);
+            this->tree.replay(inputIndex);
+            return;
+        }
+    }
+    this->tree.setKey(inputIndex, inputBatch.getRow(this->inputRows[inputIndex]).begin());
+    this->tree.replay(inputIndex);
+}
+
+bool MergeOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("MergeOperator::getNextBatch");
+    int capacity = this->getBatchCapacity();
+    batch.rowCount = 0;
+    batch.columnCount = this->columns.size();
+    batch.buffer.resize((size_t)capacity * batch.columnCount);
+    int inputIndex;
+    while (batch.rowCount < capacity && (inputIndex = this->tree.getWinner()) != -1)
+    {
+        RowView row = this->inputBatches[inputIndex].getRow(this->inputRows[inputIndex]);
+        copy(row.begin(), row.end(), batch.buffer.begin() + (size_t)batch.rowCount * batch.columnCount);
+        batch.rowCount++;
+        this->advance(inputIndex);
+    }
+    batch.cells = batch.buffer.data();
+    return batch.rowCount != 0;
+}
+
+void MergeOperator::reset()
+{
+    for (auto &input : this->inputs)
+        input->reset();
+    this->start();
+}
+
+/**
+ * @brief Construct a new SortOperator:: SortOperator object.
+ *
+ * @param child
+ * @param columnIndex column to sort on
+ * @param sortingStrategy ASC or DESC
+ * @param name used to name the temporary tables holding the runs and in the
+ * statistics
+ */
+SortOperator::SortOperator(unique_ptr<Operator> child, int columnIndex, SortingStrategy sortingStrategy, const string &name)
+    : SortOperator(move(child), vector<int>{columnIndex}, sortingStrategy, name)
+{
+}
+
+/**
+ * @brief Construct a new SortOperator:: SortOperator object that sorts
+ * lexicographically on several columns.
+ *
+ * @param child
+ * @param columnIndices columns to sort on, most significant first
+ * @param sortingStrategy ASC or DESC
+ * @param name used to name the temporary tables holding the runs and in the
+ * statistics
+ */
+SortOperator::SortOperator(unique_ptr<Operator> child, const vector<int> &columnIndices, SortingStrategy sortingStrategy, const string &name)
+{
+    logger.log("SortOperator::SortOperator");
+    static int sortCount = 0;
+    this->child = move(child);
+    this->columns = this->child->columns;
+    this->columnIndices = columnIndices;
+    this->sortingStrategy = sortingStrategy;
+    this->name = name;
+    this->sortId = sortCount++;
+}
+
+SortOperator::~SortOperator()
+{
+    this->dropRuns();
+}
+
+/**
+ * @brief Computes the order that sorts keys with an LSD radix sort, one pass
+ * per byte of the 32 bit keys. The row indices are carried along with the
+ * keys, so the sort is stable, and a pass is skipped when all keys share its
+ * byte.
+ *
+ * @param keys unsigned keys, left in sorted order
+ * @param order receives the indices of the keys in sorted order
+ */
+static void radixSortOrder(vector<uint32_t> &keys, vector<int> &order)
+{
+    size_t keyCount = keys.size();
+    order.resize(keyCount);
+    iota(order.begin(), order.end(), 0);
+    vector<size_t> counts(4 * 256, 0);
+    for (uint32_t key : keys)
+        for (int byte = 0; byte < 4; byte++)
+            counts[byte * 256 + ((key >> (8 * byte)) & 0xff)]++;
+
+    vector<uint32_t> keyBuffer(keyCount);
+    vector<int> orderBuffer(keyCount);
+    for (int byte = 0; byte < 4; byte++)
+    {
+        size_t *count = counts.data() + byte * 256;
+        if (*max_element(count, count + 256) == keyCount)
+            continue;
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++)
+        {
+            size_t digitCount = count[digit];
+            count[digit] = offset;
+            offset += digitCount;
+        }
+        int shift = 8 * byte;
+        for (size_t keyCounter = 0; keyCounter < keyCount; keyCounter++)
+        {
+            size_t position = count[(keys[keyCounter] >> shift) & 0xff]++;
+            keyBuffer[position] = keys[keyCounter];
+            orderBuffer[position] = order[keyCounter];
+        }
+        keys.swap(keyBuffer);
+        order.swap(orderBuffer);
+    }
+}
+
+/**
+ * @brief Sorts the first rowCount rows of rows in place, keeping rows with
+ * equal keys in their original order. The int keys are mapped onto unsigned
+ * keys whose ascending order is the requested order and radix sorted. With
+ * several key columns the columns are sorted on from the least significant
+ * to the most significant one, which since every pass is stable leaves the
+ * rows in lexicographic order.
+ *
+ * @param rows
+ * @param rowCount
+ */
+void SortOperator::sortRows(vector<int> &rows, long long rowCount)
+{
+    logger.log("SortOperator::sortRows");
+    int columnCount = this->columns.size();
+    uint32_t flip = this->sortingStrategy == DESC ? 0x7fffffffu : 0x80000000u;
+    vector<int> order(rowCount);
+    iota(order.begin(), order.end(), 0);
+    vector<uint32_t> keys(rowCount);
+    vector<int> passOrder;
+    vector<int> combinedOrder(rowCount);
+    for (auto column = this->columnIndices.rbegin(); column != this->columnIndices.rend(); column++)
+    {
+        for (long long rowCounter = 0; rowCounter < rowCount; rowCounter++)
+            keys[rowCounter] = (uint32_t)rows[(size_t)order[rowCounter] * columnCount + *column] ^ flip;
+        radixSortOrder(keys, passOrder);
+        for (long long rowCounter = 0; rowCounter < rowCount; rowCounter++)
+            combinedOrder[rowCounter] = order[passOrder[rowCounter]];
+        order.swap(combinedOrder);
+    }
+
+    vector<int> sortedRows(rows.size());
+    for (long long rowCounter = 0; rowCounter < rowCount; rowCounter++)
+        copy_n(rows.begin() + (size_t)order[rowCounter] * columnCount, columnCount,
+               sortedRows.begin() + (size_t)rowCounter * columnCount);
+    rows.swap(sortedRows);
+}
+
+/**
+ * @brief Creates an empty temporary table for the next run. Its name starts
+ * with # so it cannot clash with a table loaded from a CSV file. Runs are
+ * only ever read back in order, so no column statistics are kept for them.
+ *
+ * @return Table*
+ */
+Table *SortOperator::createRun()
+{
+    string runName = "#" + this->name + "_sort" + to_string(this->sortId) + "_run" + to_string(this->runCounter++);
+    return new Table(runName, this->columns);
+}
+
+/**
+ * @brief Sorts the rows collected in memory and writes them as a new run. The
+ * run still has to be inserted into the table catalogue before it is read,
+ * which is left to the caller since the catalogue must not change while runs
+ * are written on several threads.
+ *
+ * @param rows
+ * @param rowCount
+ * @return Table* the new run
+ */
+Table *SortOperator::writeRun(vector<int> &rows, long long rowCount)
+{
+    logger.log("SortOperator::writeRun");
+    this->sortRows(rows, rowCount);
+    Table *run = this->createRun();
+    TableWriter writer(run, false);
+    int columnCount = this->columns.size();
+    for (long long rowCounter = 0; rowCounter < rowCount; rowCounter++)
+        writer.writeRow(rows.data() + (size_t)rowCounter * columnCount);
+    writer.close();
+    return run;
+}
+
+/**
+ * @brief Reads all rows of source, writing a sorted run whenever runRowCount
+ * rows have been collected. The rows read after the last run are left in
+ * rows.
+ *
+ * @param source
+ * @param runRowCount
+ * @param runs receives the runs written, in input order
+ * @param rows
+ * @param rowCount number of rows left in rows
+ */
+void SortOperator::generateRuns(Operator &source, long long runRowCount, vector<Table *> &runs, vector<int> &rows, long long &rowCount)
+{
+    logger.log("SortOperator::generateRuns");
+    int columnCount = this->columns.size();
+    RowBatch batch;
+    while (source.getNextBatch(batch))
+    {
+        int rowCounter = 0;
+        while (rowCounter < batch.rowCount)
+        {
+            if (rowCount == runRowCount)
+            {
+                runs.push_back(this->writeRun(rows, rowCount));
+                rowCount = 0;
+            }
+            int copyCount = min<long long>(batch.rowCount - rowCounter, runRowCount - rowCount);
+            rows.resize((size_t)(rowCount + copyCount) * columnCount);
+            copy_n(batch.cells + (size_t)rowCounter * columnCount, (size_t)copyCount * columnCount,
+                   rows.begin() + (size_t)rowCount * columnCount);
+            rowCount += copyCount;
+            rowCounter += copyCount;
+        }
+    }
+}
+
+/**
+ * @brief Generates the runs of every part on a thread of its own. Each thread
+ * collects runs of its share of the buffer budget, and the runs are kept in
+ * the order of the parts so the merge stays stable.
+ *
+ * @param parts
+ */
+void SortOperator::generateRunsInParallel(vector<unique_ptr<Operator>> &parts)
+{
+    logger.log("SortOperator::generateRunsInParallel");
+    int partCount = parts.size();
+    long long runRowCount = (long long)max(1, this->getBufferPageCount() / partCount) * this->getBatchCapacity();
+    vector<vector<Table *>> partRuns(partCount);
+    vector<exception_ptr> errors(partCount);
+    vector<thread> workers;
+    for (int partCounter = 0; partCounter < partCount; partCounter++)
+        workers.emplace_back([&, partCounter] {
+            try
+            {
+                vector<int> rows;
+                long long rowCount = 0;
+                this->generateRuns(*parts[partCounter], runRowCount, partRuns[partCounter], rows, rowCount);
+                if (rowCount)
+                    partRuns[partCounter].push_back(this->writeRun(rows, rowCount));
+            }
+            catch (...)
+            {
+                errors[partCounter] = current_exception();
+            }
+        });
+    for (thread &worker : workers)
+        worker.join();
+    for (auto &runs : partRuns)
+        for (Table *run : runs)
+        {
+            tableCatalogue.insertTable(run);
+            this->runs.push_back(run);
+        }
+    for (exception_ptr &error : errors)
+        if (error)
+            rethrow_exception(error);
+}
+
+unique_ptr<MergeOperator> SortOperator::buildMerger(const vector<Table *> &group)
+{
+    vector<unique_ptr<Operator>> inputs;
+    for (Table *run : group)
+        inputs.emplace_back(make_unique<ScanOperator>(run));
+    return make_unique<MergeOperator>(move(inputs), this->columnIndices, this->sortingStrategy);
+}
+
+/**
+ * @brief Merges a group of runs into a new run and drops the merged ones.
+ *
+ * @param group
+ * @return Table* the new run
+ */
+Table *SortOperator::mergeRuns(const vector<Table *> &group)
+{
+    logger.log("SortOperator::mergeRuns");
+    Table *run = this->createRun();
+    unique_ptr<MergeOperator> merger = this->buildMerger(group);
+    executeOperator(*merger, run, false);
+    merger.reset();
+    tableCatalogue.insertTable(run);
+    for (Table *mergedRun : group)
+        tableCatalogue.deleteTable(mergedRun->tableName);
+    return run;
+}
+
+/**
+ * @brief Reads the whole child into sorted runs and merges them until few
+ * enough are left for the final merge. When the child can be split and is
+ * larger than the buffer budget, runs are generated on up to WORKER_COUNT
+ * threads, as long as every thread's share of the budget still makes runs of
+ * MIN_PARALLEL_RUN_PAGES pages. The merge fan-in is one less than the number
+ * of pages the buffer budget holds, since one buffer is needed for the output.
+ *
+ */
+void SortOperator::sort()
+{
+    logger.log("SortOperator::sort");
+    this->sorted = true;
+    int bufferPageCount = this->getBufferPageCount();
+    vector<unique_ptr<Operator>> parts;
+    int workerCount = min<int>(WORKER_COUNT, bufferPageCount / MIN_PARALLEL_RUN_PAGES);
+    if (workerCount > 1)
+        parts = this->child->split(workerCount, bufferPageCount);
+
+    if (parts.size() > 1)
+        this->generateRunsInParallel(parts);
+    else
+    {
+        vector<int> rows;
+        long long rowCount = 0;
+        vector<Table *> runs;
+        this->generateRuns(*this->child, (long long)bufferPageCount * this->getBatchCapacity(), runs, rows, rowCount);
+        if (runs.empty())
+        {
+            this->sortRows(rows, rowCount);
+            this->memoryRows.swap(rows);
+            this->memoryRowCount = rowCount;
+            this->memoryPosition = 0;
+            logger.log("SortOperator::sort: " + to_string(rowCount) + " rows sorted in memory");
+            ioStatistics.recordSort(this->name, rowCount ? 1 : 0, 0);
+            return;
+        }
+        if (rowCount)
+            runs.push_back(this->writeRun(rows, rowCount));
+        for (Table *run : runs)
+        {
+            tableCatalogue.insertTable(run);
+            this->runs.push_back(run);
+        }
+    }
+
+    size_t fanIn = max(2, bufferPageCount - 1);
+    int runCount = this->runs.size();
+    int passCount = 1;
+    while (this->runs.size() > fanIn)
+    {
+        vector<Table *> mergedRuns;
+        for (size_t first = 0; first < this->runs.size(); first += fanIn)
+        {
+            vector<Table *> group(this->runs.begin() + first, this->runs.begin() + min(first + fanIn, this->runs.size()));
+            mergedRuns.push_back(group.size() == 1 ? group.front() : this->mergeRuns(group));
+        }
+        this->runs = mergedRuns;
+        passCount++;
+    }
+    this->merger = this->buildMerger(this->runs);
+    logger.log("SortOperator::sort: " + to_string(runCount) + " runs from " + to_string(max<size_t>(1, parts.size())) +
+               " workers, " + to_string(passCount) + " merge passes with fan-in " + to_string(fanIn));
+    ioStatistics.recordSort(this->name, runCount, passCount);
+}
+
+bool SortOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("SortOperator::getNextBatch");
+    if (!this->sorted)
+        this->sort();
+    if (this->merger)
+        return this->merger->getNextBatch(batch);
+
+    int columnCount = this->columns.size();
+    long long rowCount = min<long long>(this->getBatchCapacity(), this->memoryRowCount - this->memoryPosition);
+    batch.rowCount = max(0LL, rowCount);
+    batch.columnCount = columnCount;
+    batch.cells = this->memoryRows.data() + (size_t)this->memoryPosition * columnCount;
+    this->memoryPosition += batch.rowCount;
+    return batch.rowCount != 0;
+}
+
+/**
+ * @brief Deletes the temporary tables of the runs.
+ *
+ */
+void SortOperator::dropRuns()
+{
+    this->merger.reset();
+    for (Table *run : this->runs)
+        tableCatalogue.deleteTable(run->tableName);
+    this->runs.clear();
+}
+
+void SortOperator::reset()
+{
+    this->dropRuns();
+    this->memoryRows.clear();
+    this->memoryRowCount = 0;
+    this->memoryPosition = 0;
+    this->sorted = false;
+    this->child->reset();
+}
+
+long long SortOperator::getMaxRowCount() const
+{
+    return this->child->getMaxRowCount();
+}
+
+bool SortOperator::isSortedOn(int columnIndex) const
+{
+    return columnIndex == this->columnIndices.front() && this->sortingStrategy == ASC;
+}
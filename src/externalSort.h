@@ -0,0 +1,106 @@
+#ifndef EXTERNALSORT_H
+#define EXTERNALSORT_H
+#include "operator.h"
+
+/**
+ * @brief A loser tree (tournament tree) picks the smallest of the current keys
+ * of leafCount sorted inputs in log2(leafCount) comparisons per row. The key
+ * of a leaf is its current row, compared on the key columns in order. Every
+ * inner node remembers the loser of the match played there and node 0 the
+ * overall winner, so after the winner's input has moved on to its next key
+ * only the matches on the path from its leaf to the root are replayed. An
+ * exhausted input loses every match and ties are won by the lower leaf, which
+ * keeps merges stable.
+ *
+ */
+class LoserTree
+{
+    vector<int> losers;
+    vector<const int *> keys;
+    vector<bool> exhausted;
+    vector<int> columnIndices;
+    bool descending = false;
+
+    bool beats(int leaf1, int leaf2) const;
+
+public:
+    LoserTree() {}
+    LoserTree(int leafCount, const vector<int> &columnIndices, bool descending);
+    void setKey(int leaf, const int *row);
+    void setExhausted(int leaf);
+    void build();
+    int getWinner() const;
+    void replay(int leaf);
+};
+
+/**
+ * @brief Merges inputs that are each sorted on columnIndices into one sorted
+ * stream, reading every input a batch (i.e. a page) at a time.
+ *
+ */
+class MergeOperator : public Operator
+{
+    vector<unique_ptr<Operator>> inputs;
+    vector<RowBatch> inputBatches;
+    vector<int> inputRows;
+    LoserTree tree;
+    vector<int> columnIndices;
+    SortingStrategy sortingStrategy;
+
+    void advance(int inputIndex);
+    void start();
+
+public:
+    MergeOperator(vector<unique_ptr<Operator>> inputs, const vector<int> &columnIndices, SortingStrategy sortingStrategy);
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+};
+
+/**
+ * @brief Sorts the rows of its child on one column, or lexicographically on
+ * several, with an external merge sort. The child is read into runs as large as the buffer budget, each run
+ * is radix sorted in memory and written to a temporary table, and the runs
+ * are then merged with one buffer per input run plus the output buffer until
+ * few enough remain for a last merge that feeds the operator's output. Runs
+ * of a child that can be split are generated on several threads. Input that
+ * fits into a single run is never written. The sort is stable.
+ *
+ */
+class SortOperator : public Operator
+{
+    static constexpr int MIN_PARALLEL_RUN_PAGES = 16;
+
+    unique_ptr<Operator> child;
+    vector<int> columnIndices;
+    SortingStrategy sortingStrategy;
+    string name;
+    int sortId;
+    bool sorted = false;
+    vector<int> memoryRows;
+    long long memoryRowCount = 0;
+    long long memoryPosition = 0;
+    vector<Table *> runs;
+    unique_ptr<MergeOperator> merger;
+    atomic<int> runCounter{0};
+
+    void sortRows(vector<int> &rows, long long rowCount);
+    Table *createRun();
+    Table *writeRun(vector<int> &rows, long long rowCount);
+    void generateRuns(Operator &source, long long runRowCount, vector<Table *> &runs, vector<int> &rows, long long &rowCount);
+    void generateRunsInParallel(vector<unique_ptr<Operator>> &parts);
+    Table *mergeRuns(const vector<Table *> &group);
+    unique_ptr<MergeOperator> buildMerger(const vector<Table *> &group);
+    void sort();
+    void dropRuns();
+
+public:
+    SortOperator(unique_ptr<Operator> child, int columnIndex, SortingStrategy sortingStrategy, const string &name);
+    SortOperator(unique_ptr<Operator> child, const vector<int> &columnIndices, SortingStrategy sortingStrategy, const string &name);
+    ~SortOperator();
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+    long long getMaxRowCount() const;
+    bool isSortedOn(int columnIndex) const;
+};
+
+#endif
@@ -5,14 +5,12 @@ int Graph::findDegree(int nodeId)
     logger.log("Graph::findDegree");
     
     int degree = 0;
-    int pageNum = 0;
+    int pageNum = this->getFirstPage(nodeId);
 
-    string currentFile = this->getPageFileName(nodeId, pageNum);
-
-    while (true)
+    while (pageNum != -1)
     {
         
-        auto [rowCount, nextPage] = this->readPageHeader(currentFile);
+        auto [rowCount, nextPage] = this->readPageHeader(pageNum);
         
         // rowCount includes:
         // - Outgoing edges (normal entries)
@@ -20,11 +18,7 @@ int Graph::findDegree(int nodeId)
         // Therefore, summing rowCount gives In-Degree + Out-Degree
         degree += rowCount;
 
-        if (nextPage == -1)
-            break;
-
         pageNum = nextPage;
-        currentFile = this->getPageFileName(nodeId, pageNum);
     }
     
     return degree;
@@ -8,42 +8,17 @@ vector<vector<int>> Graph::getNeighbors(int nodeId)
     logger.log("Graph::getNeighbors");
     vector<vector<int>> neighbors;
 
-    int pageNum = 0;
-    string currentFile = getPageFileName(nodeId, pageNum);
+    // Node without a first page has no edges
+    int pageNum = getFirstPage(nodeId);
 
-    // If first page doesn't exist, node has no edges
-    if (!fileExists(currentFile))
+    while (pageNum != -1)
     {
-        return neighbors;
-    }
-
-    while (true)
-    {
-        ifstream fin(currentFile, ios::in);
-        if (!fin.is_open())
-            break;
-
-        // Read header
-        int rowCount, nextPage;
-        fin >> rowCount >> nextPage;
-
-        // Read edges
-        for (int r = 0; r < rowCount; r++)
-        {
-            vector<int> row(this->storedColCount);
-            for (int c = 0; c < this->storedColCount; c++)
-            {
-                fin >> row[c];
-            }
-            neighbors.push_back(row);
-        }
-        fin.close();
+        int nextPage;
+        vector<vector<int>> edges = readPage(pageNum, nextPage);
+        neighbors.insert(neighbors.end(), edges.begin(), edges.end());
 
         // Follow chain
-        if (nextPage == -1)
-            break;
         pageNum = nextPage;
-        currentFile = getPageFileName(nodeId, pageNum);
     }
 
     return neighbors;
@@ -71,34 +46,6 @@ static string uniformSignature(const unordered_map<string, int> &uniformValues)
     return sig;
 }
 
-pair<vector<vector<int>>, int> readfile(string filename, int columnCount) {
-    vector<vector<int>> edges;
-    int nextpage =-1;
-     ifstream fin(filename, ios::in);
-        if (!fin.is_open())
-            return {edges,nextpage};
-
-        // Read header
-        int rowCount, nextPage;
-        fin >> rowCount >> nextPage;
-
-        // Read edges
-        for (int r = 0; r < rowCount; r++)
-        {
-            vector<int> row(columnCount);
-            for (int c = 0; c < columnCount; c++)
-            {
-                fin >> row[c];
-            }
-            edges.push_back(row);
-        }
-        fin.close();
-
-    return {edges,nextPage};
-}
-
-
-
 /**
  * @brief Find path with conditions using modified Dijkstra
  * Returns {cost, {path_nodes, edges_used}} or {-1, {{}, {}}} if no path
@@ -169,16 +116,13 @@ pair<long long, pair<vector<int>, vector<vector<int>>>> Graph::findPath(
         bestDist[stateKey] = curr.dist;
 
         // STREAMING: Process edges page-by-page directly from disk to save memory
-        int pageNum = 0;
-        string currentFile = getPageFileName(curr.node, pageNum);
+        int pageNum = getFirstPage(curr.node);
 
         
-        while (true)
+        while (pageNum != -1)
             {
-                if (!fileExists(currentFile)) break;
-                auto file_contents = readfile(currentFile, this->storedColCount);
-                int nextPage = file_contents.second;
-                auto edges = file_contents.first;
+                int nextPage;
+                auto edges = readPage(pageNum, nextPage);
 
                 for (auto &edge : edges)
                 {
@@ -224,10 +168,7 @@ pair<long long, pair<vector<int>, vector<vector<int>>>> Graph::findPath(
                     pq.push(newState);
                 }
 
-                if (nextPage == -1)
-                    break;
                 pageNum = nextPage;
-                currentFile = getPageFileName(curr.node, pageNum);
             
         }
     }
@@ -248,6 +189,7 @@ void Graph::savePathAsGraph(const string &resultName, vector<int> &path,
     // Write nodes file
     string nodesFileName = "../data/" + resultName + "_Nodes_" + dirChar + ".csv";
     ofstream nodesOut(nodesFileName);
+    ioStatistics.recordFileOpen(resultName + "_Nodes_" + dirChar);
 
     // Write header
     for (size_t i = 0; i < this->nodesTable.columns.size(); i++)
@@ -274,6 +216,7 @@ void Graph::savePathAsGraph(const string &resultName, vector<int> &path,
     // Write edges file
     string edgesFileName = "../data/" + resultName + "_Edges_" + dirChar + ".csv";
     ofstream edgesOut(edgesFileName);
+    ioStatistics.recordFileOpen(resultName + "_Edges_" + dirChar);
 
     // Write header
     for (size_t i = 0; i < this->edgesTable.columns.size(); i++)
@@ -4,11 +4,18 @@
 
 extern float BLOCK_SIZE;
 extern uint BLOCK_COUNT;
+extern size_t BUFFER_BYTES;
 extern uint PRINT_COUNT;
+extern uint PREFETCH_DEPTH;
+extern uint WORKER_COUNT;
+extern uint EXACT_DISTINCT_LIMIT;
+extern bool TEXT_PAGES;
+extern bool MMAP_PAGES;
 extern vector<string> tokenizedQuery;
 extern ParsedQuery parsedQuery;
 extern TableCatalogue tableCatalogue;
 extern GraphCatalogue graphCatalogue;
 extern BufferManager bufferManager;
+extern SegmentManager segmentManager;
 
 #endif
\ No newline at end of file
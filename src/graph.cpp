@@ -42,125 +42,126 @@ bool Graph::load()
 }
 
 /**
- * @brief Get page filename for a node
+ * @brief Name of the segment holding the adjacency pages of this graph
  */
-string Graph::getPageFileName(int nodeId, int pageNum)
+string Graph::getAdjacencySegmentName()
 {
-    return "../data/temp/" + this->edgesTable.tableName + "_Node" + to_string(nodeId) + "_" + to_string(pageNum);
+    return this->edgesTable.tableName + "_Adjacency";
 }
 
 /**
- * @brief Read header from page file: returns {rowCount, nextPageNum}
+ * @brief First adjacency page of a node, -1 if the node has no edges
  */
-pair<int, int> Graph::readPageHeader(const string &filename)
+int Graph::getFirstPage(int nodeId)
 {
-    ifstream fin(filename, ios::in);
-    int rowCount = 0, nextPage = -1;
-    if (fin.is_open())
-    {
-        fin >> rowCount >> nextPage;
-        fin.close();
-    }
-    return {rowCount, nextPage};
+    auto entry = this->firstAdjacencyPage.find(nodeId);
+    if (entry == this->firstAdjacencyPage.end())
+        return -1;
+    return entry->second;
 }
 
 /**
- * @brief Update header in page file (rewrite first line)
+ * @brief Read header of an adjacency page: returns {rowCount, nextPageNum}
  */
-void Graph::updatePageHeader(const string &filename, int rowCount, int nextPage)
+pair<int, int> Graph::readPageHeader(int pageNum)
 {
-    // Read existing content
-    ifstream fin(filename, ios::in);
-    string firstLine, rest;
-    getline(fin, firstLine); // Skip old header
-    stringstream buffer;
-    buffer << fin.rdbuf();
-    rest = buffer.str();
-    fin.close();
+    shared_ptr<Segment> segment = segmentManager.getSegment(this->getAdjacencySegmentName());
+    int header[2] = {0, -1};
+    if (segment && pageNum >= 0)
+        segment->read((off_t)pageNum * segment->pageSize, header, sizeof(header));
+    return {header[0], header[1]};
+}
 
-    // Rewrite with new header
-    ofstream fout(filename, ios::trunc);
-    fout << rowCount << " " << nextPage << endl;
-    fout << rest;
-    fout.close();
+/**
+ * @brief Overwrite the header of an adjacency page
+ */
+void Graph::updatePageHeader(int pageNum, int rowCount, int nextPage)
+{
+    shared_ptr<Segment> segment = segmentManager.getSegment(this->getAdjacencySegmentName());
+    int header[2] = {rowCount, nextPage};
+    segment->write((off_t)pageNum * segment->pageSize, header, sizeof(header));
 }
 
 /**
- * @brief Create new page file with header
+ * @brief Allocate a new empty adjacency page at the end of the segment
  */
-void Graph::createPageFile(const string &filename)
+int Graph::createPage()
 {
-    ofstream fout(filename, ios::trunc);
-    fout << "0 -1" << endl; // 0 rows, no next page
-    fout.close();
+    int pageNum = this->adjacencyPageCount++;
+    this->updatePageHeader(pageNum, 0, -1); // 0 rows, no next page
+    return pageNum;
 }
 
 /**
- * @brief Append edge to page file (after header)
+ * @brief Write edge into slot rowCount of an adjacency page (after header)
  */
-void Graph::appendEdgeToPage(const string &filename, vector<int> &edgeData)
+void Graph::appendEdgeToPage(int pageNum, int rowCount, vector<int> &edgeData)
 {
-    ofstream fout(filename, ios::app);
-    for (size_t i = 0; i < edgeData.size(); i++)
-    {
-        if (i != 0)
-            fout << " ";
-        fout << edgeData[i];
-    }
-    fout << endl;
-    fout.close();
+    shared_ptr<Segment> segment = segmentManager.getSegment(this->getAdjacencySegmentName());
+    off_t offset = (off_t)pageNum * segment->pageSize + 2 * sizeof(int) +
+                   (off_t)rowCount * this->storedColCount * sizeof(int);
+    segment->write(offset, edgeData.data(), this->storedColCount * sizeof(int));
 }
 
 /**
- * @brief Insert edge for a node - handles page creation and chaining
+ * @brief Insert edge for a node - appends to the last page of the node's
+ * chain, creating and linking a new page when it is full
  */
 void Graph::insertEdge(int nodeId, vector<int> &edgeData)
 {
-    string baseFile = getPageFileName(nodeId, 0);
-
     // If first page doesn't exist, create it
-    if (!fileExists(baseFile))
+    if (!this->lastAdjacencyPage.count(nodeId))
     {
-        createPageFile(baseFile);
+        int pageNum = createPage();
+        this->firstAdjacencyPage[nodeId] = pageNum;
+        this->lastAdjacencyPage[nodeId] = pageNum;
     }
 
-    // Find the page to insert into (follow chain to find page with space)
-    string currentFile = baseFile;
-    int pageNum = 0;
+    int pageNum = this->lastAdjacencyPage[nodeId];
+    auto [rowCount, nextPage] = readPageHeader(pageNum);
 
-    while (true)
+    if (rowCount < (int)this->maxEdgesPerPage)
     {
-        auto [rowCount, nextPage] = readPageHeader(currentFile);
+        // This page has space - append edge here
+        appendEdgeToPage(pageNum, rowCount, edgeData);
+        updatePageHeader(pageNum, rowCount + 1, nextPage);
+        return;
+    }
 
-        if (rowCount < (int)this->maxEdgesPerPage)
-        {
-            // This page has space - append edge here
-            appendEdgeToPage(currentFile, edgeData);
-            updatePageHeader(currentFile, rowCount + 1, nextPage);
-            return;
-        }
+    // Page is full - create one and link it
+    int newPageNum = createPage();
+    updatePageHeader(pageNum, rowCount, newPageNum);
+    this->lastAdjacencyPage[nodeId] = newPageNum;
 
-        // Page is full - check if there's a next page
-        if (nextPage == -1)
-        {
-            // No next page - create one and link it
-            int newPageNum = pageNum + 1;
-            string newFile = getPageFileName(nodeId, newPageNum);
-            createPageFile(newFile);
-
-            // Update current page to point to new page
-            updatePageHeader(currentFile, rowCount, newPageNum);
-
-            // Insert into new page
-            appendEdgeToPage(newFile, edgeData);
-            updatePageHeader(newFile, 1, -1);
-            return;
-        }
+    // Insert into new page
+    appendEdgeToPage(newPageNum, 0, edgeData);
+    updatePageHeader(newPageNum, 1, -1);
+}
 
-        // Move to next page
-        pageNum = nextPage;
-        currentFile = getPageFileName(nodeId, pageNum);
+/**
+ * @brief Read all edges of an adjacency page, nextPage is set from the header
+ */
+vector<vector<int>> Graph::readPage(int pageNum, int &nextPage)
+{
+    vector<vector<int>> edges;
+    nextPage = -1;
+    shared_ptr<Segment> segment = segmentManager.getSegment(this->getAdjacencySegmentName());
+    if (!segment || pageNum < 0)
+        return edges;
+
+    auto [rowCount, next] = readPageHeader(pageNum);
+    vector<int> buffer((size_t)rowCount * this->storedColCount);
+    off_t offset = (off_t)pageNum * segment->pageSize + 2 * sizeof(int);
+    if (!segment->read(offset, buffer.data(), buffer.size() * sizeof(int)))
+        return edges;
+
+    nextPage = next;
+    for (int r = 0; r < rowCount; r++)
+    {
+        auto rowStart = buffer.begin() + (size_t)r * this->storedColCount;
+        edges.emplace_back(rowStart, rowStart + this->storedColCount);
     }
+    return edges;
 }
 
 /**
@@ -175,6 +176,7 @@ bool Graph::loadAdjacencyList()
     // cout<< edgeFilePath << this->edgesTable.columnCount << endl;
 
     fstream fin(edgeFilePath, ios::in);
+    ioStatistics.recordFileOpen(this->edgesFile);
     if (!fin.is_open())
     {
         cout << "Error: Cannot open edges file" << endl;
@@ -201,6 +203,11 @@ bool Graph::loadAdjacencyList()
     if (maxRowsPerBlock <= 1)
         maxRowsPerBlock = 2;
     this->maxEdgesPerPage = maxRowsPerBlock - 1;
+    segmentManager.createSegment(this->getAdjacencySegmentName(),
+                                 (2 + (size_t)this->maxEdgesPerPage * this->storedColCount) * sizeof(int));
+    this->adjacencyPageCount = 0;
+    this->firstAdjacencyPage.clear();
+    this->lastAdjacencyPage.clear();
 
     // cout << "DEBUG: Stored columns per edge = " << this->storedColCount << endl;
     // cout << "DEBUG: maxEdgesPerPage = " << this->maxEdgesPerPage << endl;
@@ -310,7 +317,7 @@ bool Graph::unload()
     logger.log("Graph::unload");
     this->nodesTable.unload();
     this->edgesTable.unload();
-    // Page files will be cleaned up by system temp cleanup
+    segmentManager.deleteSegment(this->getAdjacencySegmentName());
     return true;
 }
 
@@ -32,19 +32,28 @@ class Graph{
         int destColumnIndex = 0;
         int weightColumnIndex = 1;
 
+        // Adjacency pages of all nodes share one segment. A page is a
+        // {rowCount, nextPage} header followed by up to maxEdgesPerPage edges;
+        // nextPage is the index of the following page of the same node.
+        int adjacencyPageCount = 0;
+        unordered_map<int, int> firstAdjacencyPage;
+        unordered_map<int, int> lastAdjacencyPage;
+
         Graph();
         Graph(string graphName, bool isDirected);
         bool load();
         bool loadAdjacencyList();
         bool unload();
         
-        // Page file operations
-        string getPageFileName(int nodeId, int pageNum);
-        pair<int, int> readPageHeader(const string& filename);
-        void updatePageHeader(const string& filename, int rowCount, int nextPage);
-        void createPageFile(const string& filename);
-        void appendEdgeToPage(const string& filename, vector<int>& edgeData);
+        // Adjacency page operations
+        string getAdjacencySegmentName();
+        int getFirstPage(int nodeId);
+        pair<int, int> readPageHeader(int pageNum);
+        void updatePageHeader(int pageNum, int rowCount, int nextPage);
+        int createPage();
+        void appendEdgeToPage(int pageNum, int rowCount, vector<int>& edgeData);
         void insertEdge(int nodeId, vector<int>& edgeData);
+        vector<vector<int>> readPage(int pageNum, int &nextPage);
         
         vector<vector<int>> getNeighbors(int nodeId);
         
@@ -0,0 +1,336 @@
+#include "global.h"
+
+/**
+ * @brief Picks the partition of a join key. Every partitioning depth mixes
+ * the key with a different seed, so rows that shared a partition at one depth
+ * are spread over the partitions of the next.
+ *
+ * @param key
+ * @param depth
+ * @param partitionCount
+ * @return int
+ */
+static int getPartition(int key, int depth, int partitionCount)
+{
+    uint64_t hash = ((uint64_t)depth << 32) | (uint32_t)key;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash % partitionCount;
+}
+
+/**
+ * @brief Construct a new HashJoinOperator:: HashJoinOperator object.
+ *
+ * @param left
+ * @param right
+ * @param columns names of the left columns followed by the right ones
+ * @param leftColumnIndex
+ * @param rightColumnIndex
+ * @param buildLeft whether the hash table is built on the left input
+ * @param name used to name the temporary tables holding the partitions and in
+ * the statistics
+ */
+HashJoinOperator::HashJoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, const vector<string> &columns,
+                                   int leftColumnIndex, int rightColumnIndex, bool buildLeft, const string &name)
+{
+    logger.log("HashJoinOperator::HashJoinOperator");
+    static int joinCount = 0;
+    this->columns = columns;
+    this->buildIsLeft = buildLeft;
+    if (buildLeft)
+    {
+        this->build = move(left);
+        this->probe = move(right);
+        this->buildColumnIndex = leftColumnIndex;
+        this->probeColumnIndex = rightColumnIndex;
+    }
+    else
+    {
+        this->build = move(right);
+        this->probe = move(left);
+        this->buildColumnIndex = rightColumnIndex;
+        this->probeColumnIndex = leftColumnIndex;
+    }
+    this->name = name;
+    this->joinId = joinCount++;
+}
+
+HashJoinOperator::~HashJoinOperator()
+{
+    this->dropPartitions();
+}
+
+/**
+ * @brief Reads the build input into memory and builds the hash table on it.
+ * Rows with the same key are chained in input order.
+ *
+ * @param buildInput
+ * @param canPartition whether the input may be partitioned instead
+ * @return true if the hash table was built
+ * @return false if the input outgrew the buffer budget, in which case the rows
+ * read so far are left in buildRows and the rest is still to be read
+ */
+bool HashJoinOperator::loadBuildInput(Operator &buildInput, bool canPartition)
+{
+    logger.log("HashJoinOperator::loadBuildInput");
+    int columnCount = buildInput.columns.size();
+    long long rowBudget = max<long long>(1, BUFFER_BYTES / (sizeof(int) * columnCount));
+    long long rowCount = 0;
+    this->buildRows.clear();
+    RowBatch batch;
+    while (buildInput.getNextBatch(batch))
+    {
+        this->buildRows.insert(this->buildRows.end(), batch.cells, batch.cells + (size_t)batch.rowCount * columnCount);
+        rowCount += batch.rowCount;
+        if (canPartition && rowCount > rowBudget)
+            return false;
+    }
+
+    this->firstMatch.clear();
+    this->firstMatch.reserve(rowCount);
+    this->nextMatch.assign(rowCount, -1);
+    for (long long rowCounter = rowCount - 1; rowCounter >= 0; rowCounter--)
+    {
+        int key = this->buildRows[(size_t)rowCounter * columnCount + this->buildColumnIndex];
+        auto inserted = this->firstMatch.emplace(key, rowCounter);
+        if (inserted.second)
+            continue;
+        this->nextMatch[rowCounter] = inserted.first->second;
+        inserted.first->second = rowCounter;
+    }
+    return true;
+}
+
+/**
+ * @brief Distributes the rows of an input over partitionCount temporary
+ * tables by the hash of their join column.
+ *
+ * @param input
+ * @param columnIndex join column of the input
+ * @param depth
+ * @param partitionCount
+ * @param bufferedRows rows already taken from the input, written first
+ * @return vector<Table *> the partitions, inserted into the table catalogue
+ */
+vector<Table *> HashJoinOperator::writePartitions(Operator &input, int columnIndex, int depth, int partitionCount, const vector<int> &bufferedRows)
+{
+    logger.log("HashJoinOperator::writePartitions");
+    int columnCount = input.columns.size();
+    vector<Table *> partitions;
+    vector<unique_ptr<TableWriter>> writers;
+    for (int partitionCounter = 0; partitionCounter < partitionCount; partitionCounter++)
+    {
+        string partitionName = "#" + this->name + "_join" + to_string(this->joinId) + "_part" + to_string(this->partitionCounter++);
+        partitions.push_back(new Table(partitionName, input.columns));
+        writers.emplace_back(make_unique<TableWriter>(partitions.back(), false));
+    }
+    auto writeRow = [&](const int *row) {
+        writers[getPartition(row[columnIndex], depth, partitionCount)]->writeRow(row);
+    };
+    for (size_t cellCounter = 0; cellCounter < bufferedRows.size(); cellCounter += columnCount)
+        writeRow(bufferedRows.data() + cellCounter);
+    RowBatch batch;
+    while (input.getNextBatch(batch))
+        for (int rowCounter = 0; rowCounter < batch.rowCount; rowCounter++)
+            writeRow(batch.cells + (size_t)rowCounter * columnCount);
+    for (int partitionCounter = 0; partitionCounter < partitionCount; partitionCounter++)
+    {
+        writers[partitionCounter]->close();
+        tableCatalogue.insertTable(partitions[partitionCounter]);
+    }
+    return partitions;
+}
+
+/**
+ * @brief Partitions both inputs, the build input being partly read already,
+ * and queues the pairs of partitions that can hold matches. As many
+ * partitions are written as it takes for each to fill about half the budget,
+ * leaving room for unevenly spread keys, but no more than the budget has page
+ * buffers for.
+ *
+ * @param buildInput
+ * @param probeInput
+ * @param depth
+ */
+void HashJoinOperator::partitionInputs(Operator &buildInput, Operator &probeInput, int depth)
+{
+    logger.log("HashJoinOperator::partitionInputs");
+    int fanOut = max(2, buildInput.getBufferPageCount() - 1);
+    int partitionCount = fanOut;
+    long long maxRowCount = buildInput.getMaxRowCount();
+    if (maxRowCount != -1)
+    {
+        long long byteCount = maxRowCount * sizeof(int) * buildInput.columns.size();
+        partitionCount = min<long long>(fanOut, max<long long>(2, 2 * byteCount / BUFFER_BYTES + 1));
+    }
+
+    vector<Table *> buildPartitions = this->writePartitions(buildInput, this->buildColumnIndex, depth, partitionCount, this->buildRows);
+    this->buildRows.clear();
+    vector<Table *> probePartitions = this->writePartitions(probeInput, this->probeColumnIndex, depth, partitionCount, {});
+    long long buildRowCount = 0;
+    for (Table *partition : buildPartitions)
+        buildRowCount += partition->rowCount;
+
+    // queued at the front so a partition is split further before its
+    // siblings are joined, keeping few temporary tables around
+    for (int partitionCounter = partitionCount - 1; partitionCounter >= 0; partitionCounter--)
+    {
+        PartitionPair pair;
+        pair.build = buildPartitions[partitionCounter];
+        pair.probe = probePartitions[partitionCounter];
+        pair.depth = pair.build->rowCount == buildRowCount ? MAX_PARTITION_DEPTH : depth + 1;
+        if (pair.build->rowCount && pair.probe->rowCount)
+            this->pendingPartitions.push_front(pair);
+        else
+        {
+            tableCatalogue.deleteTable(pair.build->tableName);
+            tableCatalogue.deleteTable(pair.probe->tableName);
+        }
+    }
+    logger.log("HashJoinOperator::partitionInputs: " + to_string(buildRowCount) + " build rows into " +
+               to_string(partitionCount) + " partitions at depth " + to_string(depth));
+    ioStatistics.recordJoin(this->name, partitionCount);
+}
+
+/**
+ * @brief Builds the hash table for the next pair of partitions, or for the
+ * inputs themselves the first time round, partitioning whatever does not fit.
+ *
+ * @return true if there is a probe input to read
+ * @return false once all partitions have been joined
+ */
+bool HashJoinOperator::startNextPartition()
+{
+    logger.log("HashJoinOperator::startNextPartition");
+    while (true)
+    {
+        this->dropCurrentPartition();
+        Operator *buildInput = this->build.get();
+        Operator *probeInput = this->probe.get();
+        int depth = 0;
+        if (this->started)
+        {
+            if (this->pendingPartitions.empty())
+                return false;
+            this->currentPartition = this->pendingPartitions.front();
+            this->pendingPartitions.pop_front();
+            this->partitionBuild = make_unique<ScanOperator>(this->currentPartition.build);
+            this->partitionProbe = make_unique<ScanOperator>(this->currentPartition.probe);
+            buildInput = this->partitionBuild.get();
+            probeInput = this->partitionProbe.get();
+            depth = this->currentPartition.depth;
+        }
+        this->started = true;
+        if (this->loadBuildInput(*buildInput, depth < MAX_PARTITION_DEPTH))
+        {
+            this->probeInput = probeInput;
+            this->probeBatch.rowCount = 0;
+            this->probeRow = 0;
+            return true;
+        }
+        this->partitionInputs(*buildInput, *probeInput, depth);
+    }
+}
+
+/**
+ * @brief Releases the hash table once the probe input has been read.
+ *
+ */
+void HashJoinOperator::finishPartition()
+{
+    this->probeInput = nullptr;
+    this->buildRows.clear();
+    this->firstMatch.clear();
+    this->nextMatch.clear();
+}
+
+/**
+ * @brief Deletes the temporary tables of the partitions being joined.
+ *
+ */
+void HashJoinOperator::dropCurrentPartition()
+{
+    this->partitionBuild.reset();
+    this->partitionProbe.reset();
+    if (this->currentPartition.build)
+    {
+        tableCatalogue.deleteTable(this->currentPartition.build->tableName);
+        tableCatalogue.deleteTable(this->currentPartition.probe->tableName);
+    }
+    this->currentPartition = PartitionPair();
+}
+
+/**
+ * @brief Deletes the temporary tables of all partitions, joined or not.
+ *
+ */
+void HashJoinOperator::dropPartitions()
+{
+    this->dropCurrentPartition();
+    for (PartitionPair &pair : this->pendingPartitions)
+    {
+        tableCatalogue.deleteTable(pair.build->tableName);
+        tableCatalogue.deleteTable(pair.probe->tableName);
+    }
+    this->pendingPartitions.clear();
+}
+
+bool HashJoinOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("HashJoinOperator::getNextBatch");
+    int capacity = this->getBatchCapacity();
+    int buildColumnCount = this->build->columns.size();
+    batch.rowCount = 0;
+    batch.columnCount = this->columns.size();
+    batch.buffer.resize((size_t)capacity * batch.columnCount);
+    int *output = batch.buffer.data();
+    while (batch.rowCount < capacity)
+    {
+        if (this->match != -1)
+        {
+            const int *buildRow = this->buildRows.data() + (size_t)this->match * buildColumnCount;
+            RowView probeRow = this->probeBatch.getRow(this->probeRow);
+            int *resultantRow = output + (size_t)batch.rowCount * batch.columnCount;
+            if (this->buildIsLeft)
+                copy(probeRow.begin(), probeRow.end(), copy(buildRow, buildRow + buildColumnCount, resultantRow));
+            else
+                copy(buildRow, buildRow + buildColumnCount, copy(probeRow.begin(), probeRow.end(), resultantRow));
+            batch.rowCount++;
+            this->match = this->nextMatch[this->match];
+            continue;
+        }
+        if (!this->probeInput)
+        {
+            if (!this->startNextPartition())
+                break;
+            continue;
+        }
+        if (++this->probeRow >= this->probeBatch.rowCount)
+        {
+            this->probeRow = 0;
+            if (!this->probeInput->getNextBatch(this->probeBatch))
+            {
+                this->finishPartition();
+                continue;
+            }
+        }
+        auto matches = this->firstMatch.find(this->probeBatch.getRow(this->probeRow)[this->probeColumnIndex]);
+        if (matches != this->firstMatch.end())
+            this->match = matches->second;
+    }
+    batch.cells = output;
+    return batch.rowCount != 0;
+}
+
+void HashJoinOperator::reset()
+{
+    this->finishPartition();
+    this->dropPartitions();
+    this->build->reset();
+    this->probe->reset();
+    this->started = false;
+    this->match = -1;
+}
@@ -0,0 +1,65 @@
+#ifndef HASHJOIN_H
+#define HASHJOIN_H
+#include "operator.h"
+
+/**
+ * @brief Joins two inputs on leftColumn == rightColumn. The rows of the build
+ * input, the one expected to be smaller, are loaded into a hash table on the
+ * join column and every row of the probe input looks up its matches there, so
+ * each input is read once. When the build input does not fit into the buffer
+ * budget both inputs are partitioned on a hash of the join column into
+ * temporary tables, with one page buffer per partition, and the partitions
+ * are joined pair by pair (a Grace hash join). A partition that is still too
+ * large is partitioned again with another hash function, unless partitioning
+ * did not make it any smaller, as happens when all its rows share one key.
+ *
+ */
+class HashJoinOperator : public Operator
+{
+    static constexpr int MAX_PARTITION_DEPTH = 8;
+
+    struct PartitionPair
+    {
+        Table *build = nullptr;
+        Table *probe = nullptr;
+        int depth = 0;
+    };
+
+    unique_ptr<Operator> build;
+    unique_ptr<Operator> probe;
+    int buildColumnIndex;
+    int probeColumnIndex;
+    bool buildIsLeft;
+    string name;
+    int joinId;
+    int partitionCounter = 0;
+    bool started = false;
+    deque<PartitionPair> pendingPartitions;
+    PartitionPair currentPartition;
+    unique_ptr<Operator> partitionBuild;
+    unique_ptr<Operator> partitionProbe;
+    Operator *probeInput = nullptr;
+    vector<int> buildRows;
+    unordered_map<int, int> firstMatch;
+    vector<int> nextMatch;
+    RowBatch probeBatch;
+    int probeRow = 0;
+    int match = -1;
+
+    bool loadBuildInput(Operator &buildInput, bool canPartition);
+    vector<Table *> writePartitions(Operator &input, int columnIndex, int depth, int partitionCount, const vector<int> &bufferedRows);
+    void partitionInputs(Operator &buildInput, Operator &probeInput, int depth);
+    bool startNextPartition();
+    void finishPartition();
+    void dropCurrentPartition();
+    void dropPartitions();
+
+public:
+    HashJoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, const vector<string> &columns,
+                     int leftColumnIndex, int rightColumnIndex, bool buildLeft, const string &name);
+    ~HashJoinOperator();
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+};
+
+#endif
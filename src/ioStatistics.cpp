@@ -0,0 +1,159 @@
+#include "global.h"
+
+void IOCounters::add(const IOCounters &other)
+{
+    this->pageRequests += other.pageRequests;
+    this->hits += other.hits;
+    this->misses += other.misses;
+    this->evictions += other.evictions;
+    this->bytesRead += other.bytesRead;
+    this->bytesWritten += other.bytesWritten;
+    this->filesOpened += other.filesOpened;
+    this->sortRuns += other.sortRuns;
+    this->mergePasses += other.mergePasses;
+    this->joinPartitions += other.joinPartitions;
+}
+
+string IOCounters::toString() const
+{
+    return "requests=" + to_string(this->pageRequests) +
+           " hits=" + to_string(this->hits) +
+           " misses=" + to_string(this->misses) +
+           " evictions=" + to_string(this->evictions) +
+           " bytes_read=" + to_string(this->bytesRead) +
+           " bytes_written=" + to_string(this->bytesWritten) +
+           " files_opened=" + to_string(this->filesOpened) +
+           " sort_runs=" + to_string(this->sortRuns) +
+           " merge_passes=" + to_string(this->mergePasses) +
+           " join_partitions=" + to_string(this->joinPartitions);
+}
+
+IOStatistics::IOStatistics()
+{
+    this->fout.open(this->statsFile, ios::out);
+}
+
+/**
+ * @brief Starts attributing I/O to a new command.
+ *
+ * @param commandName the command type, e.g. LOAD or SELECT
+ */
+void IOStatistics::beginCommand(string commandName)
+{
+    lock_guard<mutex> lock(this->statsMutex);
+    this->currentCommand = commandName;
+    this->currentCounters = IOCounters();
+}
+
+/**
+ * @brief Adds the counters of the command that just finished to its command
+ * type and appends them to the stats file. The line is also kept for STATS
+ * until the next STATS RESET.
+ *
+ */
+void IOStatistics::endCommand()
+{
+    lock_guard<mutex> lock(this->statsMutex);
+    if (this->currentCommand.empty())
+        return;
+    this->commandCounters[this->currentCommand].add(this->currentCounters);
+    this->commandCount[this->currentCommand]++;
+    this->commandSequence++;
+    string queryLine = "scope=query seq=" + to_string(this->commandSequence) +
+                       " command=" + this->currentCommand + " " + this->currentCounters.toString();
+    this->fout << queryLine << endl;
+    this->queryLines.push_back(queryLine);
+    this->currentCommand = "";
+    this->currentCounters = IOCounters();
+}
+
+void IOStatistics::record(const string &tableName, const function<void(IOCounters &)> &update)
+{
+    lock_guard<mutex> lock(this->statsMutex);
+    if (!tableName.empty() && tableName[0] == '#')
+        update(this->tableCounters["#temporary"]);
+    else
+        update(this->tableCounters[tableName]);
+    update(this->currentCounters);
+}
+
+void IOStatistics::recordPageRequest(const string &tableName, bool hit)
+{
+    this->record(tableName, [hit](IOCounters &counters) {
+        counters.pageRequests++;
+        if (hit)
+            counters.hits++;
+        else
+            counters.misses++;
+    });
+}
+
+void IOStatistics::recordEviction(const string &tableName)
+{
+    this->record(tableName, [](IOCounters &counters) { counters.evictions++; });
+}
+
+void IOStatistics::recordRead(const string &tableName, long long byteCount)
+{
+    this->record(tableName, [byteCount](IOCounters &counters) { counters.bytesRead += byteCount; });
+}
+
+void IOStatistics::recordWrite(const string &tableName, long long byteCount)
+{
+    this->record(tableName, [byteCount](IOCounters &counters) { counters.bytesWritten += byteCount; });
+}
+
+void IOStatistics::recordFileOpen(const string &tableName)
+{
+    this->record(tableName, [](IOCounters &counters) { counters.filesOpened++; });
+}
+
+void IOStatistics::recordSort(const string &tableName, long long runCount, long long passCount)
+{
+    this->record(tableName, [runCount, passCount](IOCounters &counters) {
+        counters.sortRuns += runCount;
+        counters.mergePasses += passCount;
+    });
+}
+
+void IOStatistics::recordJoin(const string &tableName, long long partitionCount)
+{
+    this->record(tableName, [partitionCount](IOCounters &counters) { counters.joinPartitions += partitionCount; });
+}
+
+/**
+ * @brief Prints the totals followed by one line per table, one line per
+ * command type and one line per statement run since the last reset, each as
+ * key=value pairs.
+ *
+ * @param out 
+ */
+void IOStatistics::print(ostream &out)
+{
+    lock_guard<mutex> lock(this->statsMutex);
+    IOCounters total;
+    for (auto &entry : this->tableCounters)
+        total.add(entry.second);
+    long long commands = 0;
+    for (auto &entry : this->commandCount)
+        commands += entry.second;
+    out << "scope=total commands=" << commands << " " << total.toString() << endl;
+    for (auto &entry : this->tableCounters)
+        out << "scope=table name=" << entry.first << " " << entry.second.toString() << endl;
+    for (auto &entry : this->commandCounters)
+        out << "scope=command name=" << entry.first
+            << " count=" << this->commandCount[entry.first] << " "
+            << entry.second.toString() << endl;
+    for (string &queryLine : this->queryLines)
+        out << queryLine << endl;
+}
+
+void IOStatistics::reset()
+{
+    lock_guard<mutex> lock(this->statsMutex);
+    this->tableCounters.clear();
+    this->commandCounters.clear();
+    this->commandCount.clear();
+    this->queryLines.clear();
+    this->currentCounters = IOCounters();
+}
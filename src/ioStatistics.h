@@ -0,0 +1,77 @@
+#ifndef IOSTATISTICS_H
+#define IOSTATISTICS_H
+#include "logger.h"
+
+/**
+ * @brief Counters of the work done on behalf of one table or one command.
+ * Page requests are calls to BufferManager::pinPage, of which hits were served
+ * from the pool and misses were read from disk. Bytes are those moved between
+ * memory and the page files (segments, text pages), files opened counts every
+ * data file opened including the CSV files of the tables. Sorts count the
+ * sorted runs they generated and the merge passes over them, hash joins the
+ * partitions they spilled to disk.
+ *
+ */
+struct IOCounters
+{
+    long long pageRequests = 0;
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    long long bytesRead = 0;
+    long long bytesWritten = 0;
+    long long filesOpened = 0;
+    long long sortRuns = 0;
+    long long mergePasses = 0;
+    long long joinPartitions = 0;
+
+    void add(const IOCounters &other);
+    string toString() const;
+};
+
+/**
+ * @brief The IOStatistics object collects IOCounters per table, per command
+ * type (LOAD, SELECT, CROSS, ...) and per executed statement. Every finished
+ * statement is appended to the stats file as one line of key=value pairs so
+ * I/O amplification can be charted per query and per command type. The
+ * temporary tables of operators (sort runs, join and distinct partitions,
+ * whose names start with #) are counted together as one table named
+ * #temporary rather than one line each; their I/O is part of the statement
+ * that created them anyway. The STATS command prints the totals in the same
+ * format and STATS RESET clears them; the stats file itself is only ever
+ * appended to. Counters are updated from the buffer manager's prefetch
+ * thread as well, so every update takes a lock.
+ *
+ */
+class IOStatistics
+{
+    string statsFile = "stats";
+    ofstream fout;
+    mutex statsMutex;
+    map<string, IOCounters> tableCounters;
+    map<string, IOCounters> commandCounters;
+    map<string, long long> commandCount;
+    vector<string> queryLines;
+    IOCounters currentCounters;
+    string currentCommand = "";
+    long long commandSequence = 0;
+
+    void record(const string &tableName, const function<void(IOCounters &)> &update);
+
+public:
+    IOStatistics();
+    void beginCommand(string commandName);
+    void endCommand();
+    void recordPageRequest(const string &tableName, bool hit);
+    void recordEviction(const string &tableName);
+    void recordRead(const string &tableName, long long byteCount);
+    void recordWrite(const string &tableName, long long byteCount);
+    void recordFileOpen(const string &tableName);
+    void recordSort(const string &tableName, long long runCount, long long passCount);
+    void recordJoin(const string &tableName, long long partitionCount);
+    void print(ostream &out);
+    void reset();
+};
+
+extern IOStatistics ioStatistics;
+#endif
@@ -11,6 +11,7 @@ class Logger{
 
     string logFile = "log";
     ofstream fout;
+    mutex logMutex;
     
     public:
 
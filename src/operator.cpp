@@ -0,0 +1,609 @@
+#include "global.h"
+
+int Operator::getColumnIndex(const string &columnName) const
+{
+    for (int columnCounter = 0; columnCounter < this->columns.size(); columnCounter++)
+        if (this->columns[columnCounter] == columnName)
+            return columnCounter;
+    return -1;
+}
+
+/**
+ * @brief Number of rows an operator that builds its own rows puts into one
+ * batch, which is as many rows of its columns as fit into a page.
+ *
+ * @return int
+ */
+int Operator::getBatchCapacity() const
+{
+    size_t rowSize = sizeof(int) * max<size_t>(1, this->columns.size());
+    return max(1, (int)((BLOCK_SIZE * 1000) / rowSize));
+}
+
+/**
+ * @brief Divides the operator into at most partCount operators that together
+ * produce its rows, each reading at least minPageCount pages.
+ *
+ * @param partCount 
+ * @param minPageCount 
+ * @return vector<unique_ptr<Operator>> empty if the operator cannot be divided
+ */
+vector<unique_ptr<Operator>> Operator::split(int /* partCount */, int /* minPageCount */)
+{
+    return {};
+}
+
+/**
+ * @brief Upper bound on the number of rows the operator produces.
+ *
+ * @return long long -1 if no bound is known
+ */
+long long Operator::getMaxRowCount() const
+{
+    return -1;
+}
+
+/**
+ * @brief Tells whether the operator is known to produce its rows in
+ * ascending order of a column.
+ *
+ * @param columnIndex
+ * @return true if the rows are sorted on the column
+ */
+bool Operator::isSortedOn(int /* columnIndex */) const
+{
+    return false;
+}
+
+/**
+ * @brief Number of pages of the operator's rows that fit into the buffer
+ * budget set with SET BUFFER.
+ *
+ * @return int at least 1
+ */
+int Operator::getBufferPageCount() const
+{
+    size_t pageBytes = sizeof(int) * max<size_t>(1, this->columns.size()) * this->getBatchCapacity();
+    return max<size_t>(1, BUFFER_BYTES / pageBytes);
+}
+
+ScanOperator::ScanOperator(Table *table)
+{
+    logger.log("ScanOperator::ScanOperator");
+    this->table = table;
+    this->columns = table->columns;
+    for (int pageIndex = 0; pageIndex < table->blockCount; pageIndex++)
+        this->pageIndices.push_back(pageIndex);
+}
+
+/**
+ * @brief Construct a new ScanOperator:: ScanOperator object that only reads
+ * the given pages of the table.
+ *
+ * @param table
+ * @param pageIndices in ascending order
+ */
+ScanOperator::ScanOperator(Table *table, const vector<int> &pageIndices)
+{
+    logger.log("ScanOperator::ScanOperator");
+    this->table = table;
+    this->columns = table->columns;
+    this->pageIndices = pageIndices;
+}
+
+/**
+ * @brief Restricts the scan to the given columns. Must be called before the
+ * first batch is read.
+ *
+ * @param columnIndices indices of the table's columns to keep, in output order
+ */
+void ScanOperator::setProjection(const vector<int> &columnIndices)
+{
+    this->projection = columnIndices;
+    this->columns.clear();
+    for (int columnIndex : columnIndices)
+        this->columns.push_back(this->table->columns[columnIndex]);
+}
+
+/**
+ * @brief Hands out the rows of the next page to be read. Without a projection
+ * the batch points into the page pinned by the scan's cursor.
+ *
+ * @param batch
+ * @return true if a batch was read
+ * @return false once all pages have been read
+ */
+bool ScanOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("ScanOperator::getNextBatch");
+    batch.rowCount = 0;
+    while (!batch.rowCount)
+    {
+        if (this->pagePosition >= this->pageIndices.size())
+            return false;
+        int pageIndex = this->pageIndices[this->pagePosition++];
+        if (!this->cursor)
+        {
+            this->cursor = make_unique<Cursor>(this->table, pageIndex);
+            this->cursor->setProjection(this->projection);
+        }
+        else if (this->cursor->pageIndex != pageIndex)
+            this->cursor->nextPage(pageIndex);
+        // a batch of maxRowsPerBlock rows is the whole page
+        this->cursor->getNextBatch(batch, this->table->maxRowsPerBlock);
+    }
+    return true;
+}
+
+void ScanOperator::reset()
+{
+    this->cursor.reset();
+    this->pagePosition = 0;
+}
+
+/**
+ * @brief Splits the pages to be read into consecutive ranges, so the first
+ * part reads the first rows.
+ *
+ * @param partCount 
+ * @param minPageCount 
+ * @return vector<unique_ptr<Operator>> 
+ */
+vector<unique_ptr<Operator>> ScanOperator::split(int partCount, int minPageCount)
+{
+    int pageCount = this->pageIndices.size();
+    partCount = min<int>(partCount, pageCount / max(1, minPageCount));
+    vector<unique_ptr<Operator>> parts;
+    if (partCount < 2)
+        return parts;
+    for (int partCounter = 0; partCounter < partCount; partCounter++)
+    {
+        vector<int> pageIndices(this->pageIndices.begin() + (long long)pageCount * partCounter / partCount,
+                                this->pageIndices.begin() + (long long)pageCount * (partCounter + 1) / partCount);
+        auto part = make_unique<ScanOperator>(this->table, pageIndices);
+        if (!this->projection.empty())
+            part->setProjection(this->projection);
+        parts.emplace_back(move(part));
+    }
+    return parts;
+}
+
+long long ScanOperator::getMaxRowCount() const
+{
+    long long rowCount = 0;
+    for (int pageIndex : this->pageIndices)
+        rowCount += this->table->rowsPerBlockCount[pageIndex];
+    return rowCount;
+}
+
+bool ScanOperator::isSortedOn(int columnIndex) const
+{
+    return !this->table->sortedDescending && this->columns[columnIndex] == this->table->sortedColumn;
+}
+
+/**
+ * @brief Construct a new SelectOperator:: SelectOperator object.
+ *
+ * @param child
+ * @param firstColumnIndex
+ * @param binaryOperator
+ * @param secondColumnIndex -1 to compare with intLiteral instead
+ * @param intLiteral
+ */
+SelectOperator::SelectOperator(unique_ptr<Operator> child, int firstColumnIndex, BinaryOperator binaryOperator, int secondColumnIndex, int intLiteral)
+{
+    logger.log("SelectOperator::SelectOperator");
+    this->child = move(child);
+    this->columns = this->child->columns;
+    this->firstColumnIndex = firstColumnIndex;
+    this->binaryOperator = binaryOperator;
+    this->secondColumnIndex = secondColumnIndex;
+    this->intLiteral = intLiteral;
+}
+
+bool SelectOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("SelectOperator::getNextBatch");
+    batch.rowCount = 0;
+    batch.columnCount = this->columns.size();
+    while (this->child->getNextBatch(this->input))
+    {
+        batch.buffer.resize((size_t)this->input.rowCount * batch.columnCount);
+        int *output = batch.buffer.data();
+        for (int rowCounter = 0; rowCounter < this->input.rowCount; rowCounter++)
+        {
+            RowView row = this->input.getRow(rowCounter);
+            int value1 = row[this->firstColumnIndex];
+            int value2 = this->secondColumnIndex == -1 ? this->intLiteral : row[this->secondColumnIndex];
+            if (!evaluateBinOp(value1, value2, this->binaryOperator))
+                continue;
+            copy(row.begin(), row.end(), output + (size_t)batch.rowCount * batch.columnCount);
+            batch.rowCount++;
+        }
+        if (batch.rowCount)
+        {
+            batch.cells = batch.buffer.data();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SelectOperator::reset()
+{
+    this->child->reset();
+}
+
+vector<unique_ptr<Operator>> SelectOperator::split(int partCount, int minPageCount)
+{
+    vector<unique_ptr<Operator>> parts = this->child->split(partCount, minPageCount);
+    for (auto &part : parts)
+        part = make_unique<SelectOperator>(move(part), this->firstColumnIndex, this->binaryOperator,
+                                           this->secondColumnIndex, this->intLiteral);
+    return parts;
+}
+
+long long SelectOperator::getMaxRowCount() const
+{
+    return this->child->getMaxRowCount();
+}
+
+bool SelectOperator::isSortedOn(int columnIndex) const
+{
+    return this->child->isSortedOn(columnIndex);
+}
+
+ProjectOperator::ProjectOperator(unique_ptr<Operator> child, const vector<int> &columnIndices)
+{
+    logger.log("ProjectOperator::ProjectOperator");
+    this->child = move(child);
+    this->columnIndices = columnIndices;
+    for (int columnIndex : columnIndices)
+        this->columns.push_back(this->child->columns[columnIndex]);
+}
+
+bool ProjectOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("ProjectOperator::getNextBatch");
+    batch.rowCount = 0;
+    batch.columnCount = this->columns.size();
+    if (!this->child->getNextBatch(this->input))
+        return false;
+    batch.buffer.resize((size_t)this->input.rowCount * batch.columnCount);
+    for (int rowCounter = 0; rowCounter < this->input.rowCount; rowCounter++)
+    {
+        RowView row = this->input.getRow(rowCounter);
+        int *projectedRow = batch.buffer.data() + (size_t)rowCounter * batch.columnCount;
+        for (int columnCounter = 0; columnCounter < batch.columnCount; columnCounter++)
+            projectedRow[columnCounter] = row[this->columnIndices[columnCounter]];
+    }
+    batch.cells = batch.buffer.data();
+    batch.rowCount = this->input.rowCount;
+    return true;
+}
+
+void ProjectOperator::reset()
+{
+    this->child->reset();
+}
+
+vector<unique_ptr<Operator>> ProjectOperator::split(int partCount, int minPageCount)
+{
+    vector<unique_ptr<Operator>> parts = this->child->split(partCount, minPageCount);
+    for (auto &part : parts)
+        part = make_unique<ProjectOperator>(move(part), this->columnIndices);
+    return parts;
+}
+
+long long ProjectOperator::getMaxRowCount() const
+{
+    return this->child->getMaxRowCount();
+}
+
+bool ProjectOperator::isSortedOn(int columnIndex) const
+{
+    return this->child->isSortedOn(this->columnIndices[columnIndex]);
+}
+
+/**
+ * @brief Construct a new BlockNestedLoopJoinOperator::
+ * BlockNestedLoopJoinOperator object that keeps every pair of rows, i.e.
+ * computes the cross product.
+ *
+ * @param left
+ * @param right
+ * @param columns names of the left columns followed by the right ones
+ */
+BlockNestedLoopJoinOperator::BlockNestedLoopJoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, const vector<string> &columns)
+{
+    logger.log("BlockNestedLoopJoinOperator::BlockNestedLoopJoinOperator");
+    this->left = move(left);
+    this->right = move(right);
+    this->columns = columns;
+}
+
+BlockNestedLoopJoinOperator::BlockNestedLoopJoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, const vector<string> &columns,
+                                                         int leftColumnIndex, BinaryOperator binaryOperator, int rightColumnIndex)
+    : BlockNestedLoopJoinOperator(move(left), move(right), columns)
+{
+    this->leftColumnIndex = leftColumnIndex;
+    this->binaryOperator = binaryOperator;
+    this->rightColumnIndex = rightColumnIndex;
+}
+
+/**
+ * @brief Reads the next block of left rows into memory and starts the right
+ * child over, unless this is the first block and the right child has not
+ * been read yet.
+ *
+ * @return true if a block was read
+ * @return false once the left child has been read
+ */
+bool BlockNestedLoopJoinOperator::loadBlock()
+{
+    logger.log("BlockNestedLoopJoinOperator::loadBlock");
+    int columnCount = this->left->columns.size();
+    // one page of the budget is left for the right child, one for the output
+    long long rowBudget = (long long)max(1, this->left->getBufferPageCount() - 2) * this->left->getBatchCapacity();
+    this->blockRows.clear();
+    this->blockRowCount = 0;
+    RowBatch batch;
+    while (this->blockRowCount < rowBudget && this->left->getNextBatch(batch))
+    {
+        this->blockRows.insert(this->blockRows.end(), batch.cells, batch.cells + (size_t)batch.rowCount * columnCount);
+        this->blockRowCount += batch.rowCount;
+    }
+    if (!this->blockRowCount)
+        return false;
+    if (this->blockCount++)
+        this->right->reset();
+    return true;
+}
+
+bool BlockNestedLoopJoinOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("BlockNestedLoopJoinOperator::getNextBatch");
+    int capacity = this->getBatchCapacity();
+    int leftColumnCount = this->left->columns.size();
+    batch.rowCount = 0;
+    batch.columnCount = this->columns.size();
+    batch.buffer.resize((size_t)capacity * batch.columnCount);
+    int *output = batch.buffer.data();
+    while (!this->finished && batch.rowCount < capacity)
+    {
+        if (this->rightRow < this->rightBatch.rowCount)
+        {
+            const int *row1 = this->blockRows.data() + (size_t)this->leftRow * leftColumnCount;
+            RowView row2 = this->rightBatch.getRow(this->rightRow++);
+            if (this->leftColumnIndex != -1 &&
+                !evaluateBinOp(row1[this->leftColumnIndex], row2[this->rightColumnIndex], this->binaryOperator))
+                continue;
+            int *resultantRow = output + (size_t)batch.rowCount * batch.columnCount;
+            copy(row2.begin(), row2.end(), copy(row1, row1 + leftColumnCount, resultantRow));
+            batch.rowCount++;
+            continue;
+        }
+
+        //The current right page is done with the current left row, move on to the next one
+        this->rightRow = 0;
+        if (this->rightBatch.rowCount && ++this->leftRow < this->blockRowCount)
+            continue;
+        this->leftRow = 0;
+        if (this->blockRowCount && this->right->getNextBatch(this->rightBatch))
+            continue;
+
+        //The right child is done with the current block, move on to the next one
+        this->rightBatch.rowCount = 0;
+        this->finished = !this->loadBlock();
+    }
+    batch.cells = output;
+    return batch.rowCount != 0;
+}
+
+void BlockNestedLoopJoinOperator::reset()
+{
+    this->left->reset();
+    this->right->reset();
+    this->blockRows.clear();
+    this->blockRowCount = 0;
+    this->blockCount = 0;
+    this->rightBatch.rowCount = 0;
+    this->leftRow = 0;
+    this->rightRow = 0;
+    this->finished = false;
+}
+
+size_t RowHash::operator()(const vector<int> &row) const
+{
+    return (*this)(row.data(), row.size());
+}
+
+size_t RowHash::operator()(const int *row, int columnCount) const
+{
+    size_t hash = columnCount;
+    for (int columnCounter = 0; columnCounter < columnCount; columnCounter++)
+        hash ^= hash * 31 + (uint)row[columnCounter] + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+/**
+ * @brief Finds the nested query a relation name of the query stands for.
+ * Nested queries are named #1, #2, ... in the order they appear in the query.
+ *
+ * @param query
+ * @param relationName
+ * @return const ParsedQuery* nullptr if relationName is not a nested query
+ */
+const ParsedQuery *findSubquery(const ParsedQuery &query, const string &relationName)
+{
+    if (relationName.size() < 2 || relationName[0] != '#')
+        return nullptr;
+    for (int subqueryCounter = 0; subqueryCounter < query.subqueries.size(); subqueryCounter++)
+        if (relationName == subqueryName(subqueryCounter))
+            return &query.subqueries[subqueryCounter];
+    return nullptr;
+}
+
+/**
+ * @brief Tells whether relationName, as used in query, is either a table or
+ * one of the query's nested queries.
+ *
+ * @param query
+ * @param relationName
+ * @return true if the relation exists
+ * @return false otherwise
+ */
+bool isRelation(const ParsedQuery &query, const string &relationName)
+{
+    return findSubquery(query, relationName) || tableCatalogue.isTable(relationName);
+}
+
+bool isColumnFromRelation(const ParsedQuery &query, const string &columnName, const string &relationName)
+{
+    vector<string> columns = getRelationColumns(query, relationName);
+    return find(columns.begin(), columns.end(), columnName) != columns.end();
+}
+
+vector<string> getRelationColumns(const ParsedQuery &query, const string &relationName)
+{
+    const ParsedQuery *subquery = findSubquery(query, relationName);
+    if (subquery)
+        return getResultColumns(*subquery);
+    if (tableCatalogue.isTable(relationName))
+        return tableCatalogue.getTable(relationName)->columns;
+    return {};
+}
+
+/**
+ * @brief Columns of the relation a query produces, worked out without running
+ * the query.
+ *
+ * @param query
+ * @return vector<string>
+ */
+vector<string> getResultColumns(const ParsedQuery &query)
+{
+    switch (query.queryType)
+    {
+    case SELECTION:
+        return getRelationColumns(query, query.selectionRelationName);
+    case PROJECTION:
+        return query.projectionColumnList;
+    case CROSS:
+        return getCrossColumns(getRelationColumns(query, query.crossFirstRelationName),
+                               getRelationColumns(query, query.crossSecondRelationName),
+                               query.crossFirstRelationName, query.crossSecondRelationName);
+    case JOIN:
+        return getCrossColumns(getRelationColumns(query, query.joinFirstRelationName),
+                               getRelationColumns(query, query.joinSecondRelationName),
+                               query.joinFirstRelationName, query.joinSecondRelationName);
+    case DISTINCT:
+        return getRelationColumns(query, query.distinctRelationName);
+    case SORT:
+        return getRelationColumns(query, query.sortRelationName);
+    default:
+        return {};
+    }
+}
+
+/**
+ * @brief Column names of the cross product (or join) of two relations. A
+ * column whose name appears in both relations is prefixed with the name of
+ * its relation; if both relations are the same i.e. CROSS a a, then they are
+ * named a1 and a2.
+ *
+ * @param columns1
+ * @param columns2
+ * @param relationName1
+ * @param relationName2
+ * @return vector<string>
+ */
+vector<string> getCrossColumns(const vector<string> &columns1, const vector<string> &columns2, string relationName1, string relationName2)
+{
+    if (relationName1 == relationName2)
+    {
+        relationName1 += "1";
+        relationName2 += "2";
+    }
+    vector<string> columns;
+    for (const string &columnName : columns1)
+    {
+        if (find(columns2.begin(), columns2.end(), columnName) != columns2.end())
+            columns.emplace_back(relationName1 + "_" + columnName);
+        else
+            columns.emplace_back(columnName);
+    }
+    for (const string &columnName : columns2)
+    {
+        if (find(columns1.begin(), columns1.end(), columnName) != columns1.end())
+            columns.emplace_back(relationName2 + "_" + columnName);
+        else
+            columns.emplace_back(columnName);
+    }
+    return columns;
+}
+
+/**
+ * @brief Builds the operator tree that produces the rows of a query.
+ *
+ * @param query a SELECT, PROJECT, CROSS, JOIN, DISTINCT or SORT query
+ * @return unique_ptr<Operator>
+ */
+unique_ptr<Operator> buildOperator(const ParsedQuery &query)
+{
+    logger.log("buildOperator");
+    switch (query.queryType)
+    {
+    case SELECTION:
+        return buildSELECTION(query);
+    case PROJECTION:
+        return buildPROJECTION(query);
+    case CROSS:
+        return buildCROSS(query);
+    case JOIN:
+        return buildJOIN(query);
+    case DISTINCT:
+        return buildDISTINCT(query);
+    case SORT:
+        return buildSORT(query);
+    default:
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Builds the operator that produces the rows of a relation used by
+ * query: a scan of the table or the operator tree of the nested query.
+ *
+ * @param query
+ * @param relationName
+ * @return unique_ptr<Operator>
+ */
+unique_ptr<Operator> buildRelationOperator(const ParsedQuery &query, const string &relationName)
+{
+    const ParsedQuery *subquery = findSubquery(query, relationName);
+    if (subquery)
+        return buildOperator(*subquery);
+    return make_unique<ScanOperator>(tableCatalogue.getTable(relationName));
+}
+
+/**
+ * @brief Runs an operator tree to completion and writes the rows it produces
+ * into the pages of resultantTable, which must have been created with the
+ * root's columns. Nothing but the result is written.
+ *
+ * @param root
+ * @param resultantTable
+ * @param gatherStatistics whether column statistics are kept for the result
+ * @return true if the result holds at least one row
+ * @return false if it is empty
+ */
+bool executeOperator(Operator &root, Table *resultantTable, bool gatherStatistics)
+{
+    logger.log("executeOperator");
+    TableWriter writer(resultantTable, gatherStatistics);
+    RowBatch batch;
+    while (root.getNextBatch(batch))
+        writer.writeRows(batch);
+    return writer.close();
+}
@@ -0,0 +1,153 @@
+#ifndef OPERATOR_H
+#define OPERATOR_H
+#include "semanticParser.h"
+
+/**
+ * @brief Operators are the building blocks a query is executed with. Every
+ * operator produces rows of its columns a batch at a time and reads the rows
+ * it works on from its child operators the same way, so a chain such as
+ * PROJECT over SELECT over a table streams each page of the table through all
+ * operators without writing any intermediate table. A batch handed out by
+ * getNextBatch is valid until the next call to getNextBatch on the same
+ * operator. reset starts the operator over from its first row. split divides
+ * the work of an operator between operators that can run on threads of their
+ * own; operators that cannot be divided return no parts. getMaxRowCount
+ * bounds the number of rows an operator produces where that is known without
+ * running it, which lets a join pick the smaller of its inputs, and
+ * isSortedOn tells whether its rows come in ascending order of a column.
+ *
+ */
+class Operator
+{
+public:
+    vector<string> columns;
+
+    virtual ~Operator() {}
+    virtual bool getNextBatch(RowBatch &batch) = 0;
+    virtual void reset() = 0;
+    virtual vector<unique_ptr<Operator>> split(int partCount, int minPageCount);
+    virtual long long getMaxRowCount() const;
+    virtual bool isSortedOn(int columnIndex) const;
+    int getColumnIndex(const string &columnName) const;
+    int getBatchCapacity() const;
+    int getBufferPageCount() const;
+};
+
+/**
+ * @brief Reads the rows of a table page by page through a cursor. The scan
+ * can be limited to some of the table's pages and to some of its columns.
+ *
+ */
+class ScanOperator : public Operator
+{
+    Table *table;
+    vector<int> pageIndices;
+    vector<int> projection;
+    size_t pagePosition = 0;
+    unique_ptr<Cursor> cursor;
+
+public:
+    ScanOperator(Table *table);
+    ScanOperator(Table *table, const vector<int> &pageIndices);
+    void setProjection(const vector<int> &columnIndices);
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+    vector<unique_ptr<Operator>> split(int partCount, int minPageCount);
+    long long getMaxRowCount() const;
+    bool isSortedOn(int columnIndex) const;
+};
+
+/**
+ * @brief Passes on the rows of its child that satisfy column binop column or
+ * column binop int_literal.
+ *
+ */
+class SelectOperator : public Operator
+{
+    unique_ptr<Operator> child;
+    RowBatch input;
+    int firstColumnIndex;
+    BinaryOperator binaryOperator;
+    int secondColumnIndex;
+    int intLiteral;
+
+public:
+    SelectOperator(unique_ptr<Operator> child, int firstColumnIndex, BinaryOperator binaryOperator, int secondColumnIndex, int intLiteral);
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+    vector<unique_ptr<Operator>> split(int partCount, int minPageCount);
+    long long getMaxRowCount() const;
+    bool isSortedOn(int columnIndex) const;
+};
+
+/**
+ * @brief Passes on the given columns of its child's rows, in the given order.
+ *
+ */
+class ProjectOperator : public Operator
+{
+    unique_ptr<Operator> child;
+    RowBatch input;
+    vector<int> columnIndices;
+
+public:
+    ProjectOperator(unique_ptr<Operator> child, const vector<int> &columnIndices);
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+    vector<unique_ptr<Operator>> split(int partCount, int minPageCount);
+    long long getMaxRowCount() const;
+    bool isSortedOn(int columnIndex) const;
+};
+
+/**
+ * @brief Pairs every row of the left child with every row of the right child,
+ * optionally keeping only the pairs for which leftColumn binop rightColumn
+ * holds. The left child is read a block at a time, as many pages as the
+ * buffer budget holds less one for the right child's page and one for the
+ * output, and the right child is read once per block, so it is read once in
+ * all when the left child fits into one block. Within a block the rows come
+ * out page of the right child by page.
+ *
+ */
+class BlockNestedLoopJoinOperator : public Operator
+{
+    unique_ptr<Operator> left;
+    unique_ptr<Operator> right;
+    vector<int> blockRows;
+    int blockRowCount = 0;
+    int blockCount = 0;
+    RowBatch rightBatch;
+    int leftRow = 0;
+    int rightRow = 0;
+    bool finished = false;
+    int leftColumnIndex = -1;
+    BinaryOperator binaryOperator = NO_BINOP_CLAUSE;
+    int rightColumnIndex = -1;
+
+    bool loadBlock();
+
+public:
+    BlockNestedLoopJoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, const vector<string> &columns);
+    BlockNestedLoopJoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, const vector<string> &columns,
+                                int leftColumnIndex, BinaryOperator binaryOperator, int rightColumnIndex);
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+};
+
+struct RowHash
+{
+    size_t operator()(const vector<int> &row) const;
+    size_t operator()(const int *row, int columnCount) const;
+};
+
+const ParsedQuery *findSubquery(const ParsedQuery &query, const string &relationName);
+bool isRelation(const ParsedQuery &query, const string &relationName);
+bool isColumnFromRelation(const ParsedQuery &query, const string &columnName, const string &relationName);
+vector<string> getRelationColumns(const ParsedQuery &query, const string &relationName);
+vector<string> getResultColumns(const ParsedQuery &query);
+vector<string> getCrossColumns(const vector<string> &columns1, const vector<string> &columns2, string relationName1, string relationName2);
+unique_ptr<Operator> buildOperator(const ParsedQuery &query);
+unique_ptr<Operator> buildRelationOperator(const ParsedQuery &query, const string &relationName);
+bool executeOperator(Operator &root, Table *resultantTable, bool gatherStatistics = true);
+
+#endif
@@ -1,6 +1,10 @@
 #include "global.h"
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "binary pages are stored little-endian");
+
 /**
- * @brief Construct a new Page object. Never used as part of the code
+ * @brief Construct an empty Page object. Used for frames of the buffer pool
+ * that do not hold a page.
  *
  */
 Page::Page()
@@ -14,67 +18,185 @@ Page::Page()
 }
 
 /**
- * @brief Construct a new Page:: Page object given the table name and page
- * index. When tables are loaded they are broken up into blocks of BLOCK_SIZE
- * and each block is stored in a different file named
- * "<tablename>_Page<pageindex>". For example, If the Page being loaded is of
- * table "R" and the pageIndex is 2 then the file name is "R_Page2". The page
- * loads the rows (or tuples) into a vector of rows (where each row is a vector
- * of integers).
+ * @brief Construct a new Page:: Page object given the table name, page index
+ * and the page's dimensions. When tables are loaded they are broken up into
+ * blocks of BLOCK_SIZE and all blocks are stored in the table's segment, block
+ * i at offset i * pageSize. With --text-pages each block is instead stored in
+ * a different file named "<tablename>_Page<pageindex>". The page loads the
+ * rows (or tuples) into one contiguous buffer in row major order. The
+ * dimensions are passed in by the buffer manager so reading a page never
+ * consults the table catalogue, which keeps it safe to do from several
+ * threads.
  *
  * @param tableName 
  * @param pageIndex 
+ * @param rowCount 
+ * @param columnCount 
  */
-Page::Page(string tableName, int pageIndex)
+Page::Page(string tableName, int pageIndex, int rowCount, int columnCount)
 {
     logger.log("Page::Page");
     this->tableName = tableName;
     this->pageIndex = pageIndex;
     this->pageName = "../data/temp/" + this->tableName + "_Page" + to_string(pageIndex);
-    Table table = *tableCatalogue.getTable(tableName);
-    this->columnCount = table.columnCount;
-    uint maxRowCount = table.maxRowsPerBlock;
-    vector<int> row(columnCount, 0);
-    this->rows.assign(maxRowCount, row);
+    this->columnCount = columnCount;
+    this->rowCount = rowCount;
 
-    ifstream fin(pageName, ios::in);
-    this->rowCount = table.rowsPerBlockCount[pageIndex];
-    int number;
-    for (uint rowCounter = 0; rowCounter < this->rowCount; rowCounter++)
+    if (TEXT_PAGES)
     {
-        for (int columnCounter = 0; columnCounter < columnCount; columnCounter++)
+        ifstream fin(pageName, ios::in);
+        ioStatistics.recordFileOpen(tableName);
+        this->readText(fin);
+        ioStatistics.recordRead(tableName, max<long long>(0, fin.tellg()));
+        fin.close();
+        return;
+    }
+    if (MMAP_PAGES)
+    {
+        if (!this->mapBinary(segmentManager.getSegment(tableName)))
         {
-            fin >> number;
-            this->rows[rowCounter][columnCounter] = number;
+            logger.log("Page::Page: cannot map page " + this->pageName);
+            this->rowCount = 0;
+            this->window = nullptr;
         }
+        return;
+    }
+    if (!this->readBinary(segmentManager.getSegment(tableName)))
+    {
+        logger.log("Page::Page: corrupt page " + this->pageName);
+        this->rowCount = 0;
+        this->rows.clear();
     }
-    fin.close();
 }
 
 /**
- * @brief Get row from page indexed by rowIndex
+ * @brief Reads the header and all cells of the page from the segment with one
+ * positioned read, the cells going straight into the row buffer.
+ *
+ * @param segment 
+ * @return true if the header matches the table and all cells were read
+ * @return false otherwise
+ */
+bool Page::readBinary(const shared_ptr<Segment> &segment)
+{
+    if (!segment)
+        return false;
+    PageHeader header;
+    this->rows.resize((size_t)this->rowCount * this->columnCount);
+    struct iovec parts[2] = {
+        {&header, sizeof(header)},
+        {this->rows.data(), this->rows.size() * sizeof(int)}};
+    if (!segment->readPage(this->pageIndex, parts, 2))
+        return false;
+    return header.formatVersion == PAGE_FORMAT_VERSION &&
+           header.rowCount == this->rowCount &&
+           header.columnCount == this->columnCount;
+}
+
+/**
+ * @brief Maps the page instead of reading it. The rows are used in place from
+ * the mapping.
+ *
+ * @param segment 
+ * @return true if the page could be mapped and its header matches the table
+ * @return false otherwise
+ */
+bool Page::mapBinary(const shared_ptr<Segment> &segment)
+{
+    if (!segment)
+        return false;
+    size_t byteCount = sizeof(PageHeader) + (size_t)this->rowCount * this->columnCount * sizeof(int);
+    this->window = segment->mapPage(this->pageIndex, byteCount);
+    if (!this->window)
+        return false;
+    const PageHeader *header = (const PageHeader *)this->window->pageStart;
+    return header->formatVersion == PAGE_FORMAT_VERSION &&
+           header->rowCount == this->rowCount &&
+           header->columnCount == this->columnCount;
+}
+
+/**
+ * @brief First cell of the page, either in the mapped window or in the row
+ * buffer owned by the page.
+ *
+ * @return const int* 
+ */
+const int *Page::getCells() const
+{
+    if (this->window)
+        return (const int *)(this->window->pageStart + sizeof(PageHeader));
+    return this->rows.data();
+}
+
+/**
+ * @brief Parses a page written with --text-pages.
+ *
+ * @param fin 
+ */
+void Page::readText(ifstream &fin)
+{
+    this->rows.resize((size_t)this->rowCount * this->columnCount);
+    for (int &cell : this->rows)
+        fin >> cell;
+}
+
+/**
+ * @brief Get row from page indexed by rowIndex. The row is not copied, the
+ * returned view points into the page.
  * 
  * @param rowIndex 
- * @return vector<int> 
+ * @return RowView empty if rowIndex is past the last row
  */
-vector<int> Page::getRow(int rowIndex)
+RowView Page::getRow(int rowIndex) const
 {
-    logger.log("Page::getRow");
-    vector<int> result;
-    result.clear();
     if (rowIndex >= this->rowCount)
-        return result;
-    return this->rows[rowIndex];
+        return RowView();
+    return RowView(this->getRowData(rowIndex), this->columnCount);
+}
+
+/**
+ * @brief Get a pointer to the first cell of the row indexed by rowIndex
+ * without copying it. The pointer is valid as long as the page is, i.e. as
+ * long as the handle through which the page was obtained is held. rowIndex
+ * must be less than the row count of the page.
+ *
+ * @param rowIndex 
+ * @return const int* 
+ */
+const int *Page::getRowData(int rowIndex) const
+{
+    return this->getCells() + (size_t)rowIndex * this->columnCount;
+}
+
+int Page::getRowCount() const
+{
+    return this->rowCount;
+}
+
+int Page::getColumnCount() const
+{
+    return this->columnCount;
 }
 
-Page::Page(string tableName, int pageIndex, vector<vector<int>> rows, int rowCount)
+/**
+ * @brief Construct a new Page:: Page object holding the first rowCount rows of
+ * cells, a row major buffer of rows with columnCount cells each. Used to write
+ * pages of new tables.
+ *
+ * @param tableName 
+ * @param pageIndex 
+ * @param cells 
+ * @param rowCount 
+ * @param columnCount 
+ */
+Page::Page(string tableName, int pageIndex, const vector<int> &cells, int rowCount, int columnCount)
 {
     logger.log("Page::Page");
     this->tableName = tableName;
     this->pageIndex = pageIndex;
-    this->rows = rows;
     this->rowCount = rowCount;
-    this->columnCount = rows[0].size();
+    this->columnCount = columnCount;
+    this->rows.assign(cells.begin(), cells.begin() + (size_t)rowCount * columnCount);
     this->pageName = "../data/temp/"+this->tableName + "_Page" + to_string(pageIndex);
 }
 
@@ -85,16 +207,30 @@ Page::Page(string tableName, int pageIndex, vector<vector<int>> rows, int rowCou
 void Page::writePage()
 {
     logger.log("Page::writePage");
-    ofstream fout(this->pageName, ios::trunc);
-    for (int rowCounter = 0; rowCounter < this->rowCount; rowCounter++)
+    if (TEXT_PAGES)
     {
-        for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+        ofstream fout(this->pageName, ios::trunc);
+        for (int rowCounter = 0; rowCounter < this->rowCount; rowCounter++)
         {
-            if (columnCounter != 0)
-                fout << " ";
-            fout << this->rows[rowCounter][columnCounter];
+            const int *row = this->getRowData(rowCounter);
+            for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+            {
+                if (columnCounter != 0)
+                    fout << " ";
+                fout << row[columnCounter];
+            }
+            fout << "\n";
         }
-        fout << endl;
+        ioStatistics.recordFileOpen(this->tableName);
+        ioStatistics.recordWrite(this->tableName, max<long long>(0, fout.tellp()));
+        fout.close();
+        return;
     }
-    fout.close();
+    PageHeader header = {PAGE_FORMAT_VERSION, this->rowCount, this->columnCount};
+    struct iovec parts[2] = {
+        {&header, sizeof(header)},
+        {(void *)this->rows.data(), this->rows.size() * sizeof(int)}};
+    shared_ptr<Segment> segment = segmentManager.getSegment(this->tableName);
+    if (!segment || !segment->writePage(this->pageIndex, parts, 2))
+        logger.log("Page::writePage: cannot write " + this->pageName);
 }
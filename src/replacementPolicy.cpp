@@ -0,0 +1,276 @@
+#include "global.h"
+
+void FIFOPolicy::recordInsert(int frameIndex, const PageId & /* pageId */)
+{
+    this->positions[frameIndex] = this->queue.insert(this->queue.end(), frameIndex);
+}
+
+/**
+ * @brief FIFO ignores accesses, the eviction order is the insertion order.
+ *
+ * @param frameIndex
+ */
+void FIFOPolicy::recordAccess(int /* frameIndex */)
+{
+}
+
+void FIFOPolicy::recordRemoval(int frameIndex)
+{
+    auto position = this->positions.find(frameIndex);
+    if (position == this->positions.end())
+        return;
+    this->queue.erase(position->second);
+    this->positions.erase(position);
+}
+
+int FIFOPolicy::pickVictim(const function<bool(int)> &isEvictable)
+{
+    for (int frameIndex : this->queue)
+        if (isEvictable(frameIndex))
+            return frameIndex;
+    return -1;
+}
+
+string FIFOPolicy::name()
+{
+    return "FIFO";
+}
+
+void LRUPolicy::recordInsert(int frameIndex, const PageId & /* pageId */)
+{
+    this->positions[frameIndex] = this->queue.insert(this->queue.end(), frameIndex);
+}
+
+void LRUPolicy::recordAccess(int frameIndex)
+{
+    auto position = this->positions.find(frameIndex);
+    if (position == this->positions.end())
+        return;
+    this->queue.splice(this->queue.end(), this->queue, position->second);
+}
+
+void LRUPolicy::recordRemoval(int frameIndex)
+{
+    auto position = this->positions.find(frameIndex);
+    if (position == this->positions.end())
+        return;
+    this->queue.erase(position->second);
+    this->positions.erase(position);
+}
+
+int LRUPolicy::pickVictim(const function<bool(int)> &isEvictable)
+{
+    for (int frameIndex : this->queue)
+        if (isEvictable(frameIndex))
+            return frameIndex;
+    return -1;
+}
+
+string LRUPolicy::name()
+{
+    return "LRU";
+}
+
+void ClockPolicy::recordInsert(int frameIndex, const PageId & /* pageId */)
+{
+    if (frameIndex >= this->present.size())
+    {
+        this->present.resize(frameIndex + 1, false);
+        this->referenced.resize(frameIndex + 1, false);
+    }
+    this->present[frameIndex] = true;
+    this->referenced[frameIndex] = true;
+}
+
+void ClockPolicy::recordAccess(int frameIndex)
+{
+    if (frameIndex < this->referenced.size())
+        this->referenced[frameIndex] = true;
+}
+
+void ClockPolicy::recordRemoval(int frameIndex)
+{
+    if (frameIndex < this->present.size())
+    {
+        this->present[frameIndex] = false;
+        this->referenced[frameIndex] = false;
+    }
+}
+
+/**
+ * @brief Advances the clock hand until it finds a present frame whose
+ * reference bit is clear. Pinned frames are skipped without touching their
+ * bit. Two full sweeps are always enough since the first sweep clears every
+ * bit it passes.
+ *
+ * @param isEvictable 
+ * @return int index of the victim frame, -1 if no frame can be evicted
+ */
+int ClockPolicy::pickVictim(const function<bool(int)> &isEvictable)
+{
+    int frameCount = this->present.size();
+    if (frameCount == 0)
+        return -1;
+    for (int step = 0; step < 2 * frameCount; step++)
+    {
+        int frameIndex = this->hand;
+        this->hand = (this->hand + 1) % frameCount;
+        if (!this->present[frameIndex] || !isEvictable(frameIndex))
+            continue;
+        if (this->referenced[frameIndex])
+        {
+            this->referenced[frameIndex] = false;
+            continue;
+        }
+        return frameIndex;
+    }
+    return -1;
+}
+
+string ClockPolicy::name()
+{
+    return "CLOCK";
+}
+
+void TwoQueuePolicy::setCapacity(int frameCount)
+{
+    this->capacity = max(1, frameCount);
+}
+
+void TwoQueuePolicy::recordInsert(int frameIndex, const PageId &pageId)
+{
+    list<int> *queue = &this->recentQueue;
+    auto ghost = this->ghosts.find(pageId);
+    if (ghost != this->ghosts.end())
+    {
+        queue = &this->frequentQueue;
+        this->ghostQueue.erase(ghost->second);
+        this->ghosts.erase(ghost);
+    }
+    this->positions[frameIndex] = {queue, queue->insert(queue->end(), frameIndex)};
+    this->framePages[frameIndex] = pageId;
+}
+
+/**
+ * @brief An access is a page being pinned again, which for a cursor means a
+ * new pass over the page rather than the next row of the same pass. The page
+ * has proven to be re-referenced and moves to the most recently used end of
+ * the main queue, from the recent queue if it was still there.
+ *
+ * @param frameIndex 
+ */
+void TwoQueuePolicy::recordAccess(int frameIndex)
+{
+    auto position = this->positions.find(frameIndex);
+    if (position == this->positions.end())
+        return;
+    this->frequentQueue.splice(this->frequentQueue.end(), *position->second.first, position->second.second);
+    position->second.first = &this->frequentQueue;
+}
+
+/**
+ * @brief A page leaving the recent queue is remembered in the ghost queue,
+ * which holds at most half as many page ids as the pool holds frames.
+ *
+ * @param frameIndex 
+ */
+void TwoQueuePolicy::recordRemoval(int frameIndex)
+{
+    auto position = this->positions.find(frameIndex);
+    if (position == this->positions.end())
+        return;
+    list<int> *queue = position->second.first;
+    queue->erase(position->second.second);
+    this->positions.erase(position);
+    PageId pageId = this->framePages[frameIndex];
+    this->framePages.erase(frameIndex);
+    if (queue != &this->recentQueue || this->ghosts.count(pageId))
+        return;
+    this->ghosts[pageId] = this->ghostQueue.insert(this->ghostQueue.end(), pageId);
+    size_t ghostLimit = max(1, this->capacity / 2);
+    while (this->ghostQueue.size() > ghostLimit)
+    {
+        this->ghosts.erase(this->ghostQueue.front());
+        this->ghostQueue.pop_front();
+    }
+}
+
+int TwoQueuePolicy::pickFrom(list<int> &queue, const function<bool(int)> &isEvictable)
+{
+    for (int frameIndex : queue)
+        if (isEvictable(frameIndex))
+            return frameIndex;
+    return -1;
+}
+
+/**
+ * @brief Evicts from the recent queue while it holds more than a quarter of
+ * the pool (or the main queue is empty) and from the least recently used end
+ * of the main queue otherwise. If every frame of the preferred queue is
+ * pinned the other queue is tried.
+ *
+ * @param isEvictable 
+ * @return int index of the victim frame, -1 if no frame can be evicted
+ */
+int TwoQueuePolicy::pickVictim(const function<bool(int)> &isEvictable)
+{
+    size_t recentLimit = max(1, this->capacity / 4);
+    bool preferRecent = this->recentQueue.size() > recentLimit || this->frequentQueue.empty();
+    list<int> &preferred = preferRecent ? this->recentQueue : this->frequentQueue;
+    list<int> &other = preferRecent ? this->frequentQueue : this->recentQueue;
+    int victim = this->pickFrom(preferred, isEvictable);
+    if (victim == -1)
+        victim = this->pickFrom(other, isEvictable);
+    return victim;
+}
+
+string TwoQueuePolicy::name()
+{
+    return "2Q";
+}
+
+/**
+ * @brief Factory that builds the replacement policy indicated by strategy.
+ *
+ * @param strategy
+ * @return ReplacementPolicy* owned by the caller
+ */
+ReplacementPolicy *createReplacementPolicy(ReplacementStrategy strategy)
+{
+    switch (strategy)
+    {
+    case LRU_REPLACEMENT:
+        return new LRUPolicy();
+    case CLOCK_REPLACEMENT:
+        return new ClockPolicy();
+    case TWOQ_REPLACEMENT:
+        return new TwoQueuePolicy();
+    default:
+        return new FIFOPolicy();
+    }
+}
+
+/**
+ * @brief Maps a policy name as typed by the user (FIFO, LRU, CLOCK or 2Q)
+ * onto a ReplacementStrategy.
+ *
+ * @param strategyName
+ * @param strategy set when the name is recognised
+ * @return true if the name is a known policy
+ * @return false otherwise
+ */
+bool parseReplacementStrategy(string strategyName, ReplacementStrategy &strategy)
+{
+    transform(strategyName.begin(), strategyName.end(), strategyName.begin(), ::toupper);
+    if (strategyName == "FIFO")
+        strategy = FIFO_REPLACEMENT;
+    else if (strategyName == "LRU")
+        strategy = LRU_REPLACEMENT;
+    else if (strategyName == "CLOCK")
+        strategy = CLOCK_REPLACEMENT;
+    else if (strategyName == "2Q")
+        strategy = TWOQ_REPLACEMENT;
+    else
+        return false;
+    return true;
+}
@@ -0,0 +1,152 @@
+#ifndef REPLACEMENTPOLICY_H
+#define REPLACEMENTPOLICY_H
+#include "logger.h"
+
+enum ReplacementStrategy
+{
+    FIFO_REPLACEMENT,
+    LRU_REPLACEMENT,
+    CLOCK_REPLACEMENT,
+    TWOQ_REPLACEMENT
+};
+
+/**
+ * @brief Identifies a page in the buffer pool by the table it belongs to and
+ * its index within that table.
+ *
+ */
+struct PageId
+{
+    string tableName;
+    int pageIndex;
+
+    bool operator==(const PageId &other) const
+    {
+        return pageIndex == other.pageIndex && tableName == other.tableName;
+    }
+};
+
+struct PageIdHash
+{
+    size_t operator()(const PageId &pageId) const
+    {
+        return hash<string>()(pageId.tableName) * 31 + hash<int>()(pageId.pageIndex);
+    }
+};
+
+/**
+ * @brief A ReplacementPolicy decides which frame of the buffer pool is given
+ * up when a new page has to be brought in and the pool is full. Frames are
+ * identified by their index in the pool; the buffer manager informs the policy
+ * whenever a frame is filled, accessed or emptied and asks it for a victim
+ * when it needs space. Frames that are pinned by a reader cannot be evicted,
+ * the buffer manager passes a predicate the policy must respect when choosing.
+ * The page placed in a frame is passed along on insertion for policies that
+ * remember pages beyond their stay in the pool, and policies that size
+ * internal queues are told how many frames the pool they serve holds.
+ *
+ */
+class ReplacementPolicy
+{
+public:
+    virtual ~ReplacementPolicy() {}
+    virtual void setCapacity(int /* frameCount */) {}
+    virtual void recordInsert(int frameIndex, const PageId &pageId) = 0;
+    virtual void recordAccess(int frameIndex) = 0;
+    virtual void recordRemoval(int frameIndex) = 0;
+    virtual int pickVictim(const function<bool(int)> &isEvictable) = 0;
+    virtual string name() = 0;
+};
+
+/**
+ * @brief First in first out. The frame that was filled earliest is evicted
+ * irrespective of how often it has been used since.
+ *
+ */
+class FIFOPolicy : public ReplacementPolicy
+{
+    list<int> queue;
+    unordered_map<int, list<int>::iterator> positions;
+
+public:
+    void recordInsert(int frameIndex, const PageId &pageId);
+    void recordAccess(int frameIndex);
+    void recordRemoval(int frameIndex);
+    int pickVictim(const function<bool(int)> &isEvictable);
+    string name();
+};
+
+/**
+ * @brief Least recently used. Every access moves the frame to the back of the
+ * queue so the front always holds the frame untouched for the longest time.
+ *
+ */
+class LRUPolicy : public ReplacementPolicy
+{
+    list<int> queue;
+    unordered_map<int, list<int>::iterator> positions;
+
+public:
+    void recordInsert(int frameIndex, const PageId &pageId);
+    void recordAccess(int frameIndex);
+    void recordRemoval(int frameIndex);
+    int pickVictim(const function<bool(int)> &isEvictable);
+    string name();
+};
+
+/**
+ * @brief CLOCK (second chance) approximation of LRU. Each frame carries a
+ * reference bit that is set on access; the hand sweeps over the frames clearing
+ * set bits and evicts the first frame whose bit is already clear.
+ *
+ */
+class ClockPolicy : public ReplacementPolicy
+{
+    vector<bool> present;
+    vector<bool> referenced;
+    int hand = 0;
+
+public:
+    void recordInsert(int frameIndex, const PageId &pageId);
+    void recordAccess(int frameIndex);
+    void recordRemoval(int frameIndex);
+    int pickVictim(const function<bool(int)> &isEvictable);
+    string name();
+};
+
+/**
+ * @brief The 2Q policy of Johnson and Shasha, which resists sequential scans.
+ * A page read for the first time enters the short FIFO queue of recent pages
+ * and, unless it is pinned again while there, leaves the pool from there
+ * without disturbing the pages in the main LRU queue. Pages evicted from the
+ * recent queue are remembered for a while in a ghost queue holding only their
+ * ids; a page read again while it is still remembered has been referenced
+ * more than once and goes straight into the main queue. This keeps pages that are
+ * read repeatedly, such as the inner relation of a CROSS, resident while a
+ * long one-off scan passes through the recent queue.
+ *
+ */
+class TwoQueuePolicy : public ReplacementPolicy
+{
+    list<int> recentQueue;
+    list<int> frequentQueue;
+    unordered_map<int, pair<list<int> *, list<int>::iterator>> positions;
+    unordered_map<int, PageId> framePages;
+    list<PageId> ghostQueue;
+    unordered_map<PageId, list<PageId>::iterator, PageIdHash> ghosts;
+    int capacity = 2;
+
+    int pickFrom(list<int> &queue, const function<bool(int)> &isEvictable);
+
+public:
+    void setCapacity(int frameCount);
+    void recordInsert(int frameIndex, const PageId &pageId);
+    void recordAccess(int frameIndex);
+    void recordRemoval(int frameIndex);
+    int pickVictim(const function<bool(int)> &isEvictable);
+    string name();
+};
+
+ReplacementPolicy *createReplacementPolicy(ReplacementStrategy strategy);
+bool parseReplacementStrategy(string strategyName, ReplacementStrategy &strategy);
+#endif
@@ -0,0 +1,159 @@
+#include "global.h"
+
+/**
+ * @brief Construct a new Segment:: Segment object. The segment file is created
+ * (or truncated if it already exists) under data/temp and kept open.
+ *
+ * @param segmentName 
+ * @param pageSize size in bytes of every page stored in the segment
+ */
+Segment::Segment(string segmentName, size_t pageSize)
+{
+    logger.log("Segment::Segment");
+    this->segmentName = segmentName;
+    this->fileName = "../data/temp/" + segmentName + ".seg";
+    this->pageSize = pageSize;
+    this->fileDescriptor = open(this->fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (this->fileDescriptor < 0)
+        logger.log("Segment::Segment: cannot open " + this->fileName);
+    else
+        ioStatistics.recordFileOpen(segmentName);
+}
+
+Segment::~Segment()
+{
+    if (this->fileDescriptor >= 0)
+        close(this->fileDescriptor);
+}
+
+/**
+ * @brief Reads page pageIndex into the buffers described by parts with a
+ * single positioned read.
+ *
+ * @param pageIndex 
+ * @param parts 
+ * @param partCount 
+ * @return true if every requested byte was read
+ * @return false otherwise
+ */
+bool Segment::readPage(int pageIndex, const struct iovec *parts, int partCount)
+{
+    size_t byteCount = 0;
+    for (int partCounter = 0; partCounter < partCount; partCounter++)
+        byteCount += parts[partCounter].iov_len;
+    off_t offset = (off_t)pageIndex * this->pageSize;
+    ioStatistics.recordRead(this->segmentName, byteCount);
+    return preadv(this->fileDescriptor, parts, partCount, offset) == (ssize_t)byteCount;
+}
+
+/**
+ * @brief Writes the buffers described by parts to page pageIndex with a single
+ * positioned write.
+ *
+ * @param pageIndex 
+ * @param parts 
+ * @param partCount 
+ * @return true if every byte was written
+ * @return false otherwise
+ */
+bool Segment::writePage(int pageIndex, const struct iovec *parts, int partCount)
+{
+    size_t byteCount = 0;
+    for (int partCounter = 0; partCounter < partCount; partCounter++)
+        byteCount += parts[partCounter].iov_len;
+    off_t offset = (off_t)pageIndex * this->pageSize;
+    ioStatistics.recordWrite(this->segmentName, byteCount);
+    return pwritev(this->fileDescriptor, parts, partCount, offset) == (ssize_t)byteCount;
+}
+
+bool Segment::read(off_t offset, void *buffer, size_t byteCount)
+{
+    ioStatistics.recordRead(this->segmentName, byteCount);
+    return pread(this->fileDescriptor, buffer, byteCount, offset) == (ssize_t)byteCount;
+}
+
+bool Segment::write(off_t offset, const void *buffer, size_t byteCount)
+{
+    ioStatistics.recordWrite(this->segmentName, byteCount);
+    return pwrite(this->fileDescriptor, buffer, byteCount, offset) == (ssize_t)byteCount;
+}
+
+/**
+ * @brief Maps the first byteCount bytes of page pageIndex into memory. The
+ * window starts at the system page boundary at or before the page so the
+ * mapping offset is properly aligned. The mapped bytes are counted as read
+ * since every one of them is touched when the page is used.
+ *
+ * @param pageIndex 
+ * @param byteCount 
+ * @return shared_ptr<MappedWindow> nullptr if the mapping failed
+ */
+shared_ptr<MappedWindow> Segment::mapPage(int pageIndex, size_t byteCount)
+{
+    static const off_t systemPageSize = sysconf(_SC_PAGESIZE);
+    off_t pageOffset = (off_t)pageIndex * this->pageSize;
+    off_t windowOffset = pageOffset - pageOffset % systemPageSize;
+    shared_ptr<MappedWindow> window = make_shared<MappedWindow>();
+    window->length = byteCount + (pageOffset - windowOffset);
+    window->address = mmap(nullptr, window->length, PROT_READ, MAP_SHARED, this->fileDescriptor, windowOffset);
+    if (window->address == MAP_FAILED)
+        return nullptr;
+    window->pageStart = (const char *)window->address + (pageOffset - windowOffset);
+    ioStatistics.recordRead(this->segmentName, byteCount);
+    return window;
+}
+
+MappedWindow::~MappedWindow()
+{
+    if (this->address != MAP_FAILED)
+        munmap(this->address, this->length);
+}
+
+/**
+ * @brief Creates a fresh segment, replacing any segment of the same name.
+ *
+ * @param segmentName 
+ * @param pageSize 
+ * @return shared_ptr<Segment> 
+ */
+shared_ptr<Segment> SegmentManager::createSegment(string segmentName, size_t pageSize)
+{
+    logger.log("SegmentManager::createSegment");
+    this->deleteSegment(segmentName);
+    shared_ptr<Segment> segment = make_shared<Segment>(segmentName, pageSize);
+    lock_guard<mutex> lock(this->segmentsMutex);
+    this->segments[segmentName] = segment;
+    return segment;
+}
+
+/**
+ * @brief Returns the open segment named segmentName.
+ *
+ * @param segmentName 
+ * @return shared_ptr<Segment> nullptr if no such segment exists
+ */
+shared_ptr<Segment> SegmentManager::getSegment(string segmentName)
+{
+    lock_guard<mutex> lock(this->segmentsMutex);
+    auto entry = this->segments.find(segmentName);
+    if (entry == this->segments.end())
+        return nullptr;
+    return entry->second;
+}
+
+/**
+ * @brief Forgets the segment and removes its file. The descriptor is closed
+ * once no reader holds the segment any more.
+ *
+ * @param segmentName 
+ */
+void SegmentManager::deleteSegment(string segmentName)
+{
+    lock_guard<mutex> lock(this->segmentsMutex);
+    auto entry = this->segments.find(segmentName);
+    if (entry == this->segments.end())
+        return;
+    logger.log("SegmentManager::deleteSegment");
+    remove(entry->second->fileName.c_str());
+    this->segments.erase(entry);
+}
@@ -0,0 +1,68 @@
+#ifndef SEGMENTMANAGER_H
+#define SEGMENTMANAGER_H
+#include "ioStatistics.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * @brief A read-only memory mapping of the part of a segment that holds one
+ * page. The mapping is released when the last reference to it goes away.
+ *
+ */
+class MappedWindow
+{
+public:
+    void *address = MAP_FAILED;
+    size_t length = 0;
+    const char *pageStart = nullptr;
+
+    ~MappedWindow();
+};
+
+/**
+ * @brief A Segment is the single file that stores every page of one relation.
+ * Pages have a fixed size within a segment so page i starts at byte
+ * i * pageSize and is read and written with positioned I/O on a descriptor
+ * that stays open for the lifetime of the segment.
+ *
+ */
+class Segment
+{
+public:
+    string segmentName = "";
+    string fileName = "";
+    size_t pageSize = 0;
+    int fileDescriptor = -1;
+
+    Segment(string segmentName, size_t pageSize);
+    ~Segment();
+    bool readPage(int pageIndex, const struct iovec *parts, int partCount);
+    bool writePage(int pageIndex, const struct iovec *parts, int partCount);
+    bool read(off_t offset, void *buffer, size_t byteCount);
+    bool write(off_t offset, const void *buffer, size_t byteCount);
+    shared_ptr<MappedWindow> mapPage(int pageIndex, size_t byteCount);
+};
+
+/**
+ * @brief The SegmentManager keeps track of the open segments under data/temp.
+ * Segments are created when a relation is blockified and deleted when the
+ * relation is unloaded. Segments are handed out as shared pointers so a read
+ * still in progress on another thread (see BufferManager prefetching) keeps
+ * the descriptor open even if the segment is deleted meanwhile.
+ *
+ */
+class SegmentManager
+{
+    unordered_map<string, shared_ptr<Segment>> segments;
+    mutex segmentsMutex;
+
+public:
+    SegmentManager() {}
+    shared_ptr<Segment> createSegment(string segmentName, size_t pageSize);
+    shared_ptr<Segment> getSegment(string segmentName);
+    void deleteSegment(string segmentName);
+};
+
+#endif
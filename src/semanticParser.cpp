@@ -1,7 +1,30 @@
 #include"global.h"
 
+/**
+ * @brief Checks every nested query of parsedQuery as if it were the query
+ * being executed.
+ *
+ * @return true if all nested queries are valid
+ * @return false otherwise
+ */
+static bool semanticParseSubqueries(){
+    logger.log("semanticParseSubqueries");
+    ParsedQuery outerParsedQuery = parsedQuery;
+    bool isValid = true;
+    for (const ParsedQuery &subquery : outerParsedQuery.subqueries){
+        parsedQuery = subquery;
+        isValid = semanticParse();
+        if (!isValid)
+            break;
+    }
+    parsedQuery = outerParsedQuery;
+    return isValid;
+}
+
 bool semanticParse(){
     logger.log("semanticParse");
+    if (!semanticParseSubqueries())
+        return false;
     switch(parsedQuery.queryType){
         case CLEAR: return semanticParseCLEAR();
         case CROSS: return semanticParseCROSS();
@@ -16,7 +39,9 @@ bool semanticParse(){
         case PROJECTION: return semanticParsePROJECTION();
         case RENAME: return semanticParseRENAME();
         case SELECTION: return semanticParseSELECTION();
+        case SET: return semanticParseSET();
         case SORT: return semanticParseSORT();
+        case STATS: return semanticParseSTATS();
         case SOURCE: return semanticParseSOURCE();
         case PATHQUERY: return semanticParsePATH();
         default: cout<<"SEMANTIC ERROR"<<endl;
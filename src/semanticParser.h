@@ -17,7 +17,9 @@ bool semanticParsePRINT();
 bool semanticParsePROJECTION();
 bool semanticParseRENAME();
 bool semanticParseSELECTION();
+bool semanticParseSET();
 bool semanticParseSORT();
+bool semanticParseSTATS();
 bool semanticParseSOURCE();
 bool semanticParsePATH();
 #endif
@@ -5,24 +5,147 @@ using namespace std;
 
 float BLOCK_SIZE = 1;
 uint BLOCK_COUNT = 2;
+size_t BUFFER_BYTES = 2000;
 uint PRINT_COUNT = 20;
+uint PREFETCH_DEPTH = 2;
+uint WORKER_COUNT = max(1u, thread::hardware_concurrency());
+uint EXACT_DISTINCT_LIMIT = 1 << 16;
+bool TEXT_PAGES = false;
+bool MMAP_PAGES = false;
 Logger logger;
+IOStatistics ioStatistics;
 vector<string> tokenizedQuery;
 ParsedQuery parsedQuery;
+SegmentManager segmentManager;
+BufferManager bufferManager;
 TableCatalogue tableCatalogue;
 GraphCatalogue graphCatalogue;
-BufferManager bufferManager;
 
+/**
+ * @brief Runs the tokenized command. Its I/O is attributed to the command
+ * type, the keyword after "<-" for assignments and the first word otherwise.
+ *
+ */
 void doCommand()
 {
     logger.log("doCommand");
+    if (tokenizedQuery.size() > 2 && tokenizedQuery[1] == "<-")
+        ioStatistics.beginCommand(tokenizedQuery[2]);
+    else
+        ioStatistics.beginCommand(tokenizedQuery[0]);
     if (syntacticParse() && semanticParse())
         executeCommand();
+    ioStatistics.endCommand();
     return;
 }
 
-int main(void)
+/**
+ * @brief Reads the startup options. Supported options are
+ * --policy=FIFO|LRU|CLOCK|2Q to choose the buffer replacement policy,
+ * --text-pages to write pages as readable text instead of binary, --mmap
+ * to read pages through memory mappings of the segments, --prefetch=N to
+ * set how many pages sequential scans read ahead (0 turns read-ahead off),
+ * --buffer-bytes=N[K|M|G] to set the memory budget of the buffer pool and
+ * --block-size=KB to set the default block size, --workers=N to set how
+ * many threads parallel operations such as LOAD use and --exact-distinct=N to
+ * set up to how many distinct values per column LOAD counts exactly before it
+ * switches to an estimate. Without --buffer-bytes the pool holds BLOCK_COUNT
+ * blocks of the chosen size.
+ *
+ * @param argc 
+ * @param argv 
+ * @return true if all options were understood
+ * @return false otherwise
+ */
+bool parseOptions(int argc, char *argv[])
+{
+    bool bufferBytesGiven = false;
+    for (int argCounter = 1; argCounter < argc; argCounter++)
+    {
+        string option = argv[argCounter];
+        if (option.rfind("--policy=", 0) == 0)
+        {
+            ReplacementStrategy strategy;
+            if (!parseReplacementStrategy(option.substr(9), strategy))
+            {
+                cout << "Unknown replacement policy: " << option.substr(9) << endl;
+                return false;
+            }
+            bufferManager.setReplacementPolicy(strategy);
+        }
+        else if (option == "--text-pages")
+            TEXT_PAGES = true;
+        else if (option == "--mmap")
+            MMAP_PAGES = true;
+        else if (option.rfind("--prefetch=", 0) == 0)
+        {
+            string depth = option.substr(11);
+            if (depth.empty() || depth.find_first_not_of("0123456789") != string::npos)
+            {
+                cout << "Invalid prefetch depth: " << depth << endl;
+                return false;
+            }
+            PREFETCH_DEPTH = stoi(depth);
+        }
+        else if (option.rfind("--buffer-bytes=", 0) == 0)
+        {
+            if (!parseByteCount(option.substr(15), BUFFER_BYTES))
+            {
+                cout << "Invalid buffer size: " << option.substr(15) << endl;
+                return false;
+            }
+            bufferBytesGiven = true;
+        }
+        else if (option.rfind("--block-size=", 0) == 0)
+        {
+            if (!parseBlockSize(option.substr(13), BLOCK_SIZE))
+            {
+                cout << "Invalid block size: " << option.substr(13) << endl;
+                return false;
+            }
+        }
+        else if (option.rfind("--workers=", 0) == 0)
+        {
+            string workerCount = option.substr(10);
+            if (workerCount.empty() || workerCount.size() > 4 ||
+                workerCount.find_first_not_of("0123456789") != string::npos || stoi(workerCount) == 0)
+            {
+                cout << "Invalid worker count: " << workerCount << endl;
+                return false;
+            }
+            WORKER_COUNT = stoi(workerCount);
+        }
+        else if (option.rfind("--exact-distinct=", 0) == 0)
+        {
+            string limit = option.substr(17);
+            if (limit.empty() || limit.size() > 9 || limit.find_first_not_of("0123456789") != string::npos)
+            {
+                cout << "Invalid exact distinct limit: " << limit << endl;
+                return false;
+            }
+            EXACT_DISTINCT_LIMIT = stoi(limit);
+        }
+        else
+        {
+            cout << "Unknown option: " << option << endl;
+            return false;
+        }
+    }
+    if (TEXT_PAGES && MMAP_PAGES)
+    {
+        cout << "--mmap cannot be combined with --text-pages" << endl;
+        return false;
+    }
+    if (!bufferBytesGiven)
+        BUFFER_BYTES = BLOCK_COUNT * (size_t)(BLOCK_SIZE * 1000);
+    bufferManager.setBufferBytes(BUFFER_BYTES);
+    return true;
+}
+
+int main(int argc, char *argv[])
 {
+    if (!parseOptions(argc, argv))
+        return 1;
 
     regex delim("[^\\s,]+");
     string command;
@@ -54,7 +177,7 @@ int main(void)
             continue;
         }
 
-        if (tokenizedQuery.size() == 1)
+        if (tokenizedQuery.size() == 1 && tokenizedQuery.front() != "STATS")
         {
             cout << "SYNTAX ERROR" << endl;
             continue;
@@ -0,0 +1,234 @@
+#include "global.h"
+
+/**
+ * @brief Construct a new SortMergeJoinOperator:: SortMergeJoinOperator
+ * object. Inputs that are not known to be sorted on their join column are
+ * sorted first.
+ *
+ * @param left
+ * @param right
+ * @param columns names of the left columns followed by the right ones
+ * @param leftColumnIndex
+ * @param binaryOperator LESS_THAN, LEQ, GREATER_THAN or GEQ
+ * @param rightColumnIndex
+ * @param name used to name the sorts and the temporary tables holding the
+ * window
+ */
+SortMergeJoinOperator::SortMergeJoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, const vector<string> &columns,
+                                             int leftColumnIndex, BinaryOperator binaryOperator, int rightColumnIndex, const string &name)
+{
+    logger.log("SortMergeJoinOperator::SortMergeJoinOperator");
+    static int joinCount = 0;
+    this->columns = columns;
+    this->binaryOperator = binaryOperator;
+    this->outerIsLeft = binaryOperator == GREATER_THAN || binaryOperator == GEQ;
+    if (this->outerIsLeft)
+    {
+        this->outer = move(left);
+        this->inner = move(right);
+        this->outerColumnIndex = leftColumnIndex;
+        this->innerColumnIndex = rightColumnIndex;
+    }
+    else
+    {
+        this->outer = move(right);
+        this->inner = move(left);
+        this->outerColumnIndex = rightColumnIndex;
+        this->innerColumnIndex = leftColumnIndex;
+    }
+    if (!this->outer->isSortedOn(this->outerColumnIndex))
+        this->outer = make_unique<SortOperator>(move(this->outer), this->outerColumnIndex, ASC, name);
+    if (!this->inner->isSortedOn(this->innerColumnIndex))
+        this->inner = make_unique<SortOperator>(move(this->inner), this->innerColumnIndex, ASC, name);
+    this->name = name;
+    this->joinId = joinCount++;
+}
+
+SortMergeJoinOperator::~SortMergeJoinOperator()
+{
+    this->dropWindow();
+}
+
+/**
+ * @brief Evaluates the join condition with the keys put back on the side of
+ * the comparison their input was given on.
+ *
+ * @param outerKey
+ * @param innerKey
+ * @return true if the rows join
+ */
+bool SortMergeJoinOperator::matches(int outerKey, int innerKey) const
+{
+    if (this->outerIsLeft)
+        return evaluateBinOp(outerKey, innerKey, this->binaryOperator);
+    return evaluateBinOp(innerKey, outerKey, this->binaryOperator);
+}
+
+/**
+ * @brief Moves the rows of the window held in memory to a temporary table.
+ *
+ */
+void SortMergeJoinOperator::spillWindow()
+{
+    logger.log("SortMergeJoinOperator::spillWindow");
+    int columnCount = this->inner->columns.size();
+    string chunkName = "#" + this->name + "_merge" + to_string(this->joinId) + "_window" + to_string(this->chunkCounter++);
+    Table *chunk = new Table(chunkName, this->inner->columns);
+    TableWriter writer(chunk, false);
+    for (long long rowCounter = 0; rowCounter < this->windowRowCount; rowCounter++)
+        writer.writeRow(this->windowRows.data() + (size_t)rowCounter * columnCount);
+    writer.close();
+    tableCatalogue.insertTable(chunk);
+    this->windowChunks.push_back(chunk);
+    this->windowRows.clear();
+    this->windowRowCount = 0;
+}
+
+/**
+ * @brief Adds the inner rows that join with outerKey to the window. Rows
+ * already in the window join with it too, as outer keys arrive in ascending
+ * order.
+ *
+ * @param outerKey
+ */
+void SortMergeJoinOperator::extendWindow(int outerKey)
+{
+    int columnCount = this->inner->columns.size();
+    long long rowBudget = max<long long>(this->inner->getBatchCapacity(), BUFFER_BYTES / (sizeof(int) * columnCount));
+    while (true)
+    {
+        if (this->innerRow >= this->innerBatch.rowCount)
+        {
+            this->innerRow = 0;
+            this->innerBatch.rowCount = 0;
+            if (this->innerExhausted || !this->inner->getNextBatch(this->innerBatch))
+            {
+                this->innerExhausted = true;
+                return;
+            }
+        }
+        RowView row = this->innerBatch.getRow(this->innerRow);
+        if (!this->matches(outerKey, row[this->innerColumnIndex]))
+            return;
+        this->windowRows.insert(this->windowRows.end(), row.begin(), row.end());
+        this->windowRowCount++;
+        this->innerRow++;
+        if (this->windowRowCount >= rowBudget)
+            this->spillWindow();
+    }
+}
+
+/**
+ * @brief Moves on to the next outer row and starts pairing it with the
+ * window.
+ *
+ * @return true if there is another outer row
+ * @return false once the outer input has been read
+ */
+bool SortMergeJoinOperator::nextOuterRow()
+{
+    if (++this->outerRow >= this->outerBatch.rowCount)
+    {
+        this->outerRow = 0;
+        if (!this->outer->getNextBatch(this->outerBatch))
+            return false;
+    }
+    this->extendWindow(this->outerBatch.getRow(this->outerRow)[this->outerColumnIndex]);
+    this->chunkPosition = 0;
+    this->chunkScan.reset();
+    this->chunkBatch.rowCount = 0;
+    this->chunkRow = 0;
+    this->windowPosition = 0;
+    return true;
+}
+
+/**
+ * @brief Hands out the next row of the window to pair the current outer row
+ * with, reading the window's temporary tables before the rows in memory.
+ *
+ * @return const int* nullptr once the whole window has been handed out
+ */
+const int *SortMergeJoinOperator::nextWindowRow()
+{
+    int columnCount = this->inner->columns.size();
+    while (this->chunkPosition < this->windowChunks.size())
+    {
+        if (!this->chunkScan)
+            this->chunkScan = make_unique<ScanOperator>(this->windowChunks[this->chunkPosition]);
+        if (this->chunkRow < this->chunkBatch.rowCount)
+            return this->chunkBatch.cells + (size_t)this->chunkRow++ * columnCount;
+        this->chunkRow = 0;
+        if (!this->chunkScan->getNextBatch(this->chunkBatch))
+        {
+            this->chunkScan.reset();
+            this->chunkBatch.rowCount = 0;
+            this->chunkPosition++;
+        }
+    }
+    if (this->windowPosition < this->windowRowCount)
+        return this->windowRows.data() + (size_t)this->windowPosition++ * columnCount;
+    return nullptr;
+}
+
+/**
+ * @brief Deletes the temporary tables of the window.
+ *
+ */
+void SortMergeJoinOperator::dropWindow()
+{
+    this->chunkScan.reset();
+    for (Table *chunk : this->windowChunks)
+        tableCatalogue.deleteTable(chunk->tableName);
+    this->windowChunks.clear();
+    this->windowRows.clear();
+    this->windowRowCount = 0;
+}
+
+bool SortMergeJoinOperator::getNextBatch(RowBatch &batch)
+{
+    logger.log("SortMergeJoinOperator::getNextBatch");
+    int capacity = this->getBatchCapacity();
+    int innerColumnCount = this->inner->columns.size();
+    batch.rowCount = 0;
+    batch.columnCount = this->columns.size();
+    batch.buffer.resize((size_t)capacity * batch.columnCount);
+    int *output = batch.buffer.data();
+    while (!this->finished && batch.rowCount < capacity)
+    {
+        if (!this->pairing)
+        {
+            this->pairing = this->nextOuterRow();
+            this->finished = !this->pairing;
+            continue;
+        }
+        const int *innerRow = this->nextWindowRow();
+        if (!innerRow)
+        {
+            this->pairing = false;
+            continue;
+        }
+        RowView outerRow = this->outerBatch.getRow(this->outerRow);
+        int *resultantRow = output + (size_t)batch.rowCount * batch.columnCount;
+        if (this->outerIsLeft)
+            copy(innerRow, innerRow + innerColumnCount, copy(outerRow.begin(), outerRow.end(), resultantRow));
+        else
+            copy(outerRow.begin(), outerRow.end(), copy(innerRow, innerRow + innerColumnCount, resultantRow));
+        batch.rowCount++;
+    }
+    batch.cells = output;
+    return batch.rowCount != 0;
+}
+
+void SortMergeJoinOperator::reset()
+{
+    this->dropWindow();
+    this->outer->reset();
+    this->inner->reset();
+    this->outerBatch.rowCount = 0;
+    this->outerRow = 0;
+    this->innerBatch.rowCount = 0;
+    this->innerRow = 0;
+    this->innerExhausted = false;
+    this->pairing = false;
+    this->finished = false;
+}
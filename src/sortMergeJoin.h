@@ -0,0 +1,59 @@
+#ifndef SORTMERGEJOIN_H
+#define SORTMERGEJOIN_H
+#include "externalSort.h"
+
+/**
+ * @brief Joins two inputs on leftColumn binop rightColumn for binop one of <,
+ * <=, > and >=. Both inputs are read in ascending order of their join column,
+ * sorted with an external sort unless they are known to be sorted already.
+ * The input on the greater side of the comparison is the outer one: the
+ * inner rows that match an outer row are a prefix of the inner input, and
+ * since the outer keys only grow, that prefix only ever grows as well. The
+ * prefix is kept as a window that every outer row is paired with, so the
+ * inner input is read once and the outer one once. The window is held in
+ * memory up to the buffer budget and written to temporary tables beyond it.
+ *
+ */
+class SortMergeJoinOperator : public Operator
+{
+    unique_ptr<Operator> outer;
+    unique_ptr<Operator> inner;
+    int outerColumnIndex;
+    int innerColumnIndex;
+    BinaryOperator binaryOperator;
+    bool outerIsLeft;
+    string name;
+    int joinId;
+    int chunkCounter = 0;
+    RowBatch outerBatch;
+    int outerRow = 0;
+    RowBatch innerBatch;
+    int innerRow = 0;
+    bool innerExhausted = false;
+    bool pairing = false;
+    bool finished = false;
+    vector<Table *> windowChunks;
+    vector<int> windowRows;
+    long long windowRowCount = 0;
+    size_t chunkPosition = 0;
+    unique_ptr<ScanOperator> chunkScan;
+    RowBatch chunkBatch;
+    int chunkRow = 0;
+    long long windowPosition = 0;
+
+    bool matches(int outerKey, int innerKey) const;
+    void spillWindow();
+    void extendWindow(int outerKey);
+    bool nextOuterRow();
+    const int *nextWindowRow();
+    void dropWindow();
+
+public:
+    SortMergeJoinOperator(unique_ptr<Operator> left, unique_ptr<Operator> right, const vector<string> &columns,
+                          int leftColumnIndex, BinaryOperator binaryOperator, int rightColumnIndex, const string &name);
+    ~SortMergeJoinOperator();
+    bool getNextBatch(RowBatch &batch);
+    void reset();
+};
+
+#endif
@@ -5,6 +5,9 @@ bool syntacticParse()
     logger.log("syntacticParse");
     string possibleQueryType = tokenizedQuery[0];
 
+    if (possibleQueryType == "STATS")
+        return syntacticParseSTATS();
+
     if (tokenizedQuery.size() < 2)
     {
         cout << "SYNTAX ERROR" << endl;
@@ -29,6 +32,8 @@ bool syntacticParse()
         return syntacticParseDEGREE();
     else if(possibleQueryType == "SOURCE")
         return syntacticParseSOURCE();
+    else if(possibleQueryType == "SET")
+        return syntacticParseSET();
     else if(tokenizedQuery.size() >=6 && tokenizedQuery[2] == "PATH")
         return syntacticParsePATH();
     else
@@ -39,6 +44,8 @@ bool syntacticParse()
             cout << "SYNTAX ERROR" << endl;
             return false;
         }
+        if (!syntacticParseSubqueries())
+            return false;
         possibleQueryType = tokenizedQuery[2];
         if (possibleQueryType == "PROJECT")
             return syntacticParsePROJECTION();
@@ -93,6 +100,7 @@ void ParsedQuery::clear()
     this->joinSecondColumnName = "";
 
     this->loadRelationName = "";
+    this->loadBlockSize = 0;
 
     this->printRelationName = "";
 
@@ -112,6 +120,13 @@ void ParsedQuery::clear()
     this->selectionSecondColumnName = "";
     this->selectionIntLiteral = 0;
 
+    this->setParameterName = "";
+    this->setBufferBytes = 0;
+    this->setBlockSize = 0;
+    this->setReplacementStrategy = FIFO_REPLACEMENT;
+
+    this->statsReset = false;
+
     this->sortingStrategy = NO_SORT_CLAUSE;
     this->sortResultRelationName = "";
     this->sortColumnName = "";
@@ -129,6 +144,149 @@ void ParsedQuery::clear()
 
     this->degreeGraphName = "";
     this->degreeNodeId = 0;
+
+    this->subqueries.clear();
+}
+
+string subqueryName(int subqueryIndex)
+{
+    return "#" + to_string(subqueryIndex + 1);
+}
+
+/**
+ * @brief Parses the tokens of a nested query as if they were the query
+ * "name <- tokens".
+ *
+ * @param tokens 
+ * @param name 
+ * @param subquery set to the parsed query
+ * @return true if the tokens form a query that can be nested
+ * @return false otherwise
+ */
+static bool syntacticParseSubquery(const vector<string> &tokens, string name, ParsedQuery &subquery)
+{
+    logger.log("syntacticParseSubquery");
+    vector<string> outerTokenizedQuery = tokenizedQuery;
+    ParsedQuery outerParsedQuery = parsedQuery;
+    tokenizedQuery = {name, "<-"};
+    tokenizedQuery.insert(tokenizedQuery.end(), tokens.begin(), tokens.end());
+    parsedQuery.clear();
+    bool isValid = syntacticParse();
+    subquery = parsedQuery;
+    tokenizedQuery = outerTokenizedQuery;
+    parsedQuery = outerParsedQuery;
+    if (!isValid)
+        return false;
+    switch (subquery.queryType)
+    {
+    case CROSS:
+    case DISTINCT:
+    case JOIN:
+    case PROJECTION:
+    case SELECTION:
+    case SORT:
+        return true;
+    default:
+        cout << "SYNTAX ERROR" << endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Tells whether the parenthesis opening tokens[beginCounter, endCounter)
+ * is closed by its last token.
+ *
+ */
+static bool isWrappedQuery(const vector<string> &tokens, int beginCounter, int endCounter)
+{
+    int depth = 0;
+    for (int tokenCounter = beginCounter; tokenCounter < endCounter; tokenCounter++)
+    {
+        if (tokens[tokenCounter] == "(")
+            depth++;
+        else if (tokens[tokenCounter] == ")" && --depth == 0)
+            return tokenCounter == endCounter - 1;
+    }
+    return false;
+}
+
+/**
+ * @brief A relation name in a SELECT, PROJECT, CROSS, JOIN, DISTINCT or SORT
+ * query may be replaced by another such query in parentheses, e.g.
+ * R <- PROJECT a FROM (SELECT a > 5 FROM T). Every parenthesised query is
+ * parsed into parsedQuery.subqueries and replaced in tokenizedQuery by its
+ * name, #1 for the first one, #2 for the second and so on, so the outer query
+ * can be parsed as if it named a table.
+ *
+ * @return true if the parentheses are balanced and every nested query is valid
+ * @return false otherwise
+ */
+bool syntacticParseSubqueries()
+{
+    logger.log("syntacticParseSubqueries");
+    vector<string> tokens;
+    for (const string &token : tokenizedQuery)
+    {
+        size_t begin = token.find_first_not_of('(');
+        if (begin == string::npos)
+            begin = token.size();
+        size_t end = token.find_last_not_of(')');
+        end = (end == string::npos || end < begin) ? begin : end + 1;
+        tokens.insert(tokens.end(), begin, "(");
+        if (end > begin)
+            tokens.emplace_back(token.substr(begin, end - begin));
+        tokens.insert(tokens.end(), token.size() - end, ")");
+    }
+    if (find(tokens.begin(), tokens.end(), "(") == tokens.end() && find(tokens.begin(), tokens.end(), ")") == tokens.end())
+        return true;
+
+    vector<string> foldedTokens;
+    for (int tokenCounter = 0; tokenCounter < tokens.size(); tokenCounter++)
+    {
+        if (tokens[tokenCounter] == ")")
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return false;
+        }
+        if (tokens[tokenCounter] != "(")
+        {
+            foldedTokens.emplace_back(tokens[tokenCounter]);
+            continue;
+        }
+        int depth = 1;
+        int closingCounter = tokenCounter + 1;
+        for (; closingCounter < tokens.size() && depth; closingCounter++)
+        {
+            if (tokens[closingCounter] == "(")
+                depth++;
+            else if (tokens[closingCounter] == ")")
+                depth--;
+        }
+        if (depth)
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return false;
+        }
+        int beginCounter = tokenCounter + 1;
+        int endCounter = closingCounter - 1;
+        //Redundant parentheses as in ((SELECT ...)) are dropped
+        while (endCounter - beginCounter >= 2 && tokens[beginCounter] == "(" && tokens[endCounter - 1] == ")" &&
+               isWrappedQuery(tokens, beginCounter, endCounter))
+        {
+            beginCounter++;
+            endCounter--;
+        }
+        vector<string> subqueryTokens(tokens.begin() + beginCounter, tokens.begin() + endCounter);
+        string name = subqueryName(parsedQuery.subqueries.size());
+        ParsedQuery subquery;
+        if (!syntacticParseSubquery(subqueryTokens, name, subquery))
+            return false;
+        parsedQuery.subqueries.emplace_back(subquery);
+        foldedTokens.emplace_back(name);
+        tokenCounter = closingCounter - 1;
+    }
+    tokenizedQuery = foldedTokens;
+    return true;
 }
 
 /**
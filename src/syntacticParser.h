@@ -20,7 +20,9 @@ enum QueryType
     PROJECTION,
     RENAME,
     SELECTION,
+    SET,
     SORT,
+    STATS,
     SOURCE,
     UNDETERMINED,
     PATHQUERY   
@@ -89,6 +91,7 @@ public:
     string joinSecondColumnName = "";
 
     string loadRelationName = "";
+    float loadBlockSize = 0;
 
     string printRelationName = "";
 
@@ -108,6 +111,13 @@ public:
     string selectionSecondColumnName = "";
     int selectionIntLiteral = 0;
 
+    string setParameterName = "";
+    size_t setBufferBytes = 0;
+    float setBlockSize = 0;
+    ReplacementStrategy setReplacementStrategy = FIFO_REPLACEMENT;
+
+    bool statsReset = false;
+
     SortingStrategy sortingStrategy = NO_SORT_CLAUSE;
     string sortResultRelationName = "";
     string sortColumnName = "";
@@ -128,6 +138,9 @@ public:
     string degreeGraphName = "";
     int degreeNodeId = 0;
 
+    // Nested queries used in place of relation names, named #1, #2, ...
+    vector<ParsedQuery> subqueries;
+
     ParsedQuery();
     void clear();
 };
@@ -146,9 +159,13 @@ bool syntacticParsePRINT();
 bool syntacticParsePROJECTION();
 bool syntacticParseRENAME();
 bool syntacticParseSELECTION();
+bool syntacticParseSET();
 bool syntacticParseSORT();
+bool syntacticParseSTATS();
 bool syntacticParseSOURCE();
 bool syntacticParsePATH();
+bool syntacticParseSubqueries();
+string subqueryName(int subqueryIndex);
 
 bool isFileExists(string tableName);
 bool isGraphExists(string graphName, char graphType);
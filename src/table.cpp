@@ -23,10 +23,23 @@ Table::Table(string tableName)
     this->tableName = tableName;
 }
 
+/**
+ * @brief Construct a new Table:: Table object for a LOAD that asks for its
+ * own block size (in KB, like BLOCK_SIZE) instead of the default.
+ *
+ * @param tableName 
+ * @param blockSize 
+ */
+Table::Table(string tableName, float blockSize) : Table(tableName)
+{
+    this->blockSize = blockSize;
+}
+
 /**
  * @brief Construct a new Table:: Table object used when an assignment command
  * is encountered. To create the table object both the table name and the
- * columns the table holds should be specified.
+ * columns the table holds should be specified. The rows are then written with
+ * a TableWriter.
  *
  * @param tableName 
  * @param columns 
@@ -38,8 +51,7 @@ Table::Table(string tableName, vector<string> columns)
     this->tableName = tableName;
     this->columns = columns;
     this->columnCount = columns.size();
-    this->maxRowsPerBlock = (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * columnCount));
-    this->writeRow<string>(columns);
+    this->maxRowsPerBlock = (uint)((this->blockSize * 1000) / (sizeof(int) * columnCount));
 }
 
 /**
@@ -54,6 +66,7 @@ bool Table::load()
 {
     logger.log("Table::load");
     fstream fin(this->sourceFileName, ios::in);
+    ioStatistics.recordFileOpen(this->tableName);
     string line;
     if (getline(fin, line))
     {
@@ -72,7 +85,7 @@ bool Table::load()
  *
  * @param line 
  * @return true if column names successfully extracted (i.e. no column name
- * repeats)
+ * repeats and a row fits into a block)
  * @return false otherwise
  */
 bool Table::extractColumnNames(string firstLine)
@@ -90,13 +103,70 @@ bool Table::extractColumnNames(string firstLine)
         this->columns.emplace_back(word);
     }
     this->columnCount = this->columns.size();
-    this->maxRowsPerBlock = (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * this->columnCount));
+    this->maxRowsPerBlock = (uint)((this->blockSize * 1000) / (sizeof(int) * this->columnCount));
+    if (this->maxRowsPerBlock == 0)
+    {
+        logger.log("Table::extractColumnNames: block too small for one row");
+        return false;
+    }
     return true;
 }
 
+/**
+ * @brief Runs work on every range, each on a thread of its own when there is
+ * more than one range.
+ *
+ * @param ranges 
+ * @param work 
+ */
+static void forEachRange(vector<LoadRange> &ranges, const function<void(LoadRange &)> &work)
+{
+    if (ranges.size() == 1)
+    {
+        work(ranges.front());
+        return;
+    }
+    vector<thread> workers;
+    for (LoadRange &range : ranges)
+        workers.emplace_back(work, ref(range));
+    for (thread &worker : workers)
+        worker.join();
+}
+
+/**
+ * @brief Computes the zone map of a page, the smallest and largest value of
+ * every column among its rows.
+ *
+ * @param cells rows of the page in row major order
+ * @param rowCount 
+ * @param columnCount 
+ * @param minValues receives columnCount minimums
+ * @param maxValues receives columnCount maximums
+ */
+void computeZoneMap(const int *cells, int rowCount, int columnCount, int *minValues, int *maxValues)
+{
+    copy(cells, cells + columnCount, minValues);
+    copy(cells, cells + columnCount, maxValues);
+    for (int rowCounter = 1; rowCounter < rowCount; rowCounter++)
+    {
+        const int *row = cells + (size_t)rowCounter * columnCount;
+        for (int columnCounter = 0; columnCounter < columnCount; columnCounter++)
+        {
+            minValues[columnCounter] = min(minValues[columnCounter], row[columnCounter]);
+            maxValues[columnCounter] = max(maxValues[columnCounter], row[columnCounter]);
+        }
+    }
+}
+
 /**
  * @brief This function splits all the rows and stores them in multiple files of
- * one block size. 
+ * one block size. Rows are parsed by a CsvReader straight into the buffer of
+ * the page being filled. Files of several MIN_LOAD_RANGE_BYTES are split into
+ * line aligned ranges that are loaded by up to WORKER_COUNT threads: the rows
+ * of every range but the last are counted first, which fixes the row, and so
+ * the page, each range starts at. The pages are therefore exactly those a
+ * single thread would have written. The zone map of every page is recorded
+ * along the way.
  *
  * @return true if successfully blockified
  * @return false otherwise
@@ -104,68 +174,272 @@ bool Table::extractColumnNames(string firstLine)
 bool Table::blockify()
 {
     logger.log("Table::blockify");
-    ifstream fin(this->sourceFileName, ios::in);
-    string line, word;
-    vector<int> row(this->columnCount, 0);
-    vector<vector<int>> rowsInPage(this->maxRowsPerBlock, row);
+    ioStatistics.recordFileOpen(this->tableName);
+    struct stat sourceStatus;
+    off_t fileSize = stat(this->sourceFileName.c_str(), &sourceStatus) == 0 ? sourceStatus.st_size : 0;
+    int rangeCount = max<off_t>(1, min<off_t>(WORKER_COUNT, fileSize / MIN_LOAD_RANGE_BYTES));
+    vector<LoadRange> ranges = this->splitSourceFile(fileSize, rangeCount);
+    if (!TEXT_PAGES)
+        segmentManager.createSegment(this->tableName, this->getPageSize());
+
+    if (ranges.size() > 1)
+    {
+        vector<LoadRange> countedRanges(ranges.begin(), ranges.end() - 1);
+        forEachRange(countedRanges, [this](LoadRange &range) { this->countRows(range); });
+        for (int rangeCounter = 1; rangeCounter < ranges.size(); rangeCounter++)
+            ranges[rangeCounter].firstRow = ranges[rangeCounter - 1].firstRow + countedRanges[rangeCounter - 1].rowCount;
+    }
+    forEachRange(ranges, [this](LoadRange &range) {
+        try
+        {
+            this->blockifyRange(range);
+        }
+        catch (...)
+        {
+            range.error = current_exception();
+        }
+    });
+    for (LoadRange &range : ranges)
+    {
+        if (range.error)
+            rethrow_exception(range.error);
+        if (range.failed)
+            return false;
+    }
+
+    this->columnStatistics.assign(this->columnCount, ColumnStatistics());
+    for (LoadRange &range : ranges)
+        this->updateStatistics(range);
+    this->finishStatistics();
+    if (this->rowCount == 0)
+        return false;
+
+    this->blockCount = (this->rowCount + this->maxRowsPerBlock - 1) / this->maxRowsPerBlock;
+    this->pageMinValues.assign((size_t)this->blockCount * this->columnCount, 0);
+    this->pageMaxValues.assign((size_t)this->blockCount * this->columnCount, 0);
+    for (LoadRange &range : ranges)
+    {
+        size_t firstZone = (size_t)((range.firstRow + this->maxRowsPerBlock - 1) / this->maxRowsPerBlock) * this->columnCount;
+        copy(range.zoneMinValues.begin(), range.zoneMinValues.end(), this->pageMinValues.begin() + firstZone);
+        copy(range.zoneMaxValues.begin(), range.zoneMaxValues.end(), this->pageMaxValues.begin() + firstZone);
+    }
+
+    // pages shared by neighbouring ranges are put together from the rows
+    // the workers handed back, which arrive in row order
+    vector<int> rowsInPage((size_t)this->maxRowsPerBlock * this->columnCount, 0);
+    long long pageIndex = -1;
     int pageCounter = 0;
-    unordered_set<int> dummy;
-    dummy.clear();
-    this->distinctValuesInColumns.assign(this->columnCount, dummy);
-    this->distinctValuesPerColumnCount.assign(this->columnCount, 0);
-    getline(fin, line);
-    while (getline(fin, line))
+    auto writeAssembledPage = [&]() {
+        size_t firstZone = (size_t)pageIndex * this->columnCount;
+        computeZoneMap(rowsInPage.data(), pageCounter, this->columnCount,
+                       &this->pageMinValues[firstZone], &this->pageMaxValues[firstZone]);
+        bufferManager.writePage(this->tableName, pageIndex, rowsInPage, pageCounter, this->columnCount);
+    };
+    auto addRows = [&](long long firstRow, const vector<int> &cells) {
+        for (size_t cellCounter = 0; cellCounter < cells.size(); cellCounter += this->columnCount)
+        {
+            long long rowIndex = firstRow + cellCounter / this->columnCount;
+            if (rowIndex / this->maxRowsPerBlock != pageIndex)
+            {
+                if (pageCounter)
+                    writeAssembledPage();
+                pageIndex = rowIndex / this->maxRowsPerBlock;
+                pageCounter = 0;
+            }
+            copy(cells.begin() + cellCounter, cells.begin() + cellCounter + this->columnCount,
+                 rowsInPage.begin() + (size_t)pageCounter * this->columnCount);
+            pageCounter++;
+        }
+    };
+    for (LoadRange &range : ranges)
     {
-        stringstream s(line);
-        for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+        addRows(range.firstRow, range.headCells);
+        addRows(range.tailFirstRow, range.tailCells);
+    }
+    if (pageCounter)
+        writeAssembledPage();
+
+    this->rowsPerBlockCount.assign(this->blockCount, this->maxRowsPerBlock);
+    this->rowsPerBlockCount.back() = this->rowCount - (long long)(this->blockCount - 1) * this->maxRowsPerBlock;
+    return true;
+}
+
+/**
+ * @brief Splits the rows of the source file, i.e. everything after the header
+ * line, into rangeCount byte ranges of about the same size. Every range but
+ * the first is moved forward to the start of a line.
+ *
+ * @param fileSize 
+ * @param rangeCount 
+ * @return vector<LoadRange> 
+ */
+vector<LoadRange> Table::splitSourceFile(off_t fileSize, int rangeCount)
+{
+    logger.log("Table::splitSourceFile");
+    const char *line, *lineEnd;
+    CsvReader reader(this->sourceFileName);
+    reader.nextLine(line, lineEnd);
+    off_t dataBegin = reader.getLineOffset();
+    vector<LoadRange> ranges(rangeCount);
+    off_t beginOffset = dataBegin;
+    for (int rangeCounter = 0; rangeCounter < rangeCount; rangeCounter++)
+    {
+        off_t endOffset = fileSize;
+        off_t splitOffset = dataBegin + (fileSize - dataBegin) * (rangeCounter + 1) / rangeCount;
+        if (rangeCounter < rangeCount - 1)
         {
-            if (!getline(s, word, ','))
-                return false;
-            row[columnCounter] = stoi(word);
-            rowsInPage[pageCounter][columnCounter] = row[columnCounter];
+            endOffset = beginOffset;
+            if (splitOffset > beginOffset)
+            {
+                CsvReader boundary(this->sourceFileName, splitOffset - 1, fileSize);
+                boundary.nextLine(line, lineEnd);
+                endOffset = boundary.getLineOffset();
+            }
         }
+        ranges[rangeCounter].beginOffset = beginOffset;
+        ranges[rangeCounter].endOffset = endOffset;
+        beginOffset = endOffset;
+    }
+    return ranges;
+}
+
+/**
+ * @brief Counts the rows of a range without parsing them.
+ *
+ * @param range 
+ */
+void Table::countRows(LoadRange &range)
+{
+    logger.log("Table::countRows");
+    const char *line, *lineEnd;
+    CsvReader reader(this->sourceFileName, range.beginOffset, range.endOffset);
+    while (reader.nextLine(line, lineEnd))
+        range.rowCount++;
+}
+
+/**
+ * @brief Parses the rows of one range. Pages that lie completely inside the
+ * range are written to the buffer manager at the page index that follows
+ * from range.firstRow, the rows of the range's first and last page are kept
+ * in the range if those pages are shared with other ranges. Stops at the first
+ * row with a missing field and marks the range as failed.
+ *
+ * @param range 
+ */
+void Table::blockifyRange(LoadRange &range)
+{
+    logger.log("Table::blockifyRange");
+    const char *line, *lineEnd;
+    CsvReader reader(this->sourceFileName, range.beginOffset, range.endOffset);
+    vector<int> rowsInPage((size_t)this->maxRowsPerBlock * this->columnCount, 0);
+    range.columnStatistics.assign(this->columnCount, ColumnStatistics());
+    long long rowIndex = range.firstRow;
+    int pageCounter = rowIndex % this->maxRowsPerBlock;
+    while (reader.nextLine(line, lineEnd))
+    {
+        int *row = &rowsInPage[(size_t)pageCounter * this->columnCount];
+        for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+            if (!parseField(line, lineEnd, row[columnCounter]))
+            {
+                range.failed = true;
+                return;
+            }
+        for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+            range.columnStatistics[columnCounter].add(row[columnCounter]);
         pageCounter++;
-        this->updateStatistics(row);
+        rowIndex++;
         if (pageCounter == this->maxRowsPerBlock)
         {
-            bufferManager.writePage(this->tableName, this->blockCount, rowsInPage, pageCounter);
-            this->blockCount++;
-            this->rowsPerBlockCount.emplace_back(pageCounter);
+            long long pageFirstRow = rowIndex - pageCounter;
+            if (pageFirstRow >= range.firstRow)
+            {
+                size_t firstZone = range.zoneMinValues.size();
+                range.zoneMinValues.resize(firstZone + this->columnCount);
+                range.zoneMaxValues.resize(firstZone + this->columnCount);
+                computeZoneMap(rowsInPage.data(), pageCounter, this->columnCount,
+                               &range.zoneMinValues[firstZone], &range.zoneMaxValues[firstZone]);
+                bufferManager.writePage(this->tableName, pageFirstRow / this->maxRowsPerBlock, rowsInPage, pageCounter, this->columnCount);
+            }
+            else
+                range.headCells.assign(rowsInPage.begin() + (range.firstRow - pageFirstRow) * this->columnCount,
+                                       rowsInPage.begin() + (size_t)pageCounter * this->columnCount);
             pageCounter = 0;
         }
     }
-    if (pageCounter)
+    range.rowCount = rowIndex - range.firstRow;
+    if (!pageCounter)
+        return;
+    long long pageFirstRow = rowIndex - pageCounter;
+    vector<int>::iterator rowsEnd = rowsInPage.begin() + (size_t)pageCounter * this->columnCount;
+    if (pageFirstRow >= range.firstRow)
     {
-        bufferManager.writePage(this->tableName, this->blockCount, rowsInPage, pageCounter);
-        this->blockCount++;
-        this->rowsPerBlockCount.emplace_back(pageCounter);
-        pageCounter = 0;
+        range.tailFirstRow = pageFirstRow;
+        range.tailCells.assign(rowsInPage.begin(), rowsEnd);
     }
+    else
+        range.headCells.assign(rowsInPage.begin() + (range.firstRow - pageFirstRow) * this->columnCount, rowsEnd);
+}
 
-    if (this->rowCount == 0)
+/**
+ * @brief Size in bytes of one page of this table in its segment: a page
+ * header followed by room for maxRowsPerBlock rows.
+ *
+ * @return size_t 
+ */
+size_t Table::getPageSize()
+{
+    return sizeof(PageHeader) + (size_t)this->maxRowsPerBlock * this->columnCount * sizeof(int);
+}
+
+/**
+ * @brief Looks up the zone map of a page.
+ *
+ * @param pageIndex 
+ * @param columnIndex 
+ * @param minValue set to the smallest value of the column within the page
+ * @param maxValue set to the largest value of the column within the page
+ * @return true if the table has a zone map for the page
+ * @return false otherwise
+ */
+bool Table::getPageValueRange(int pageIndex, int columnIndex, int &minValue, int &maxValue)
+{
+    size_t zoneIndex = (size_t)pageIndex * this->columnCount + columnIndex;
+    if (zoneIndex >= this->pageMinValues.size())
         return false;
-    this->distinctValuesInColumns.clear();
+    minValue = this->pageMinValues[zoneIndex];
+    maxValue = this->pageMaxValues[zoneIndex];
     return true;
 }
 
 /**
- * @brief Given a row of values, this function will update the statistics it
- * stores i.e. it updates the number of rows that are present in the column and
- * the number of distinct values present in each column. These statistics are to
- * be used during optimisation.
+ * @brief Adds the rows of a loaded range to the statistics the table stores
+ * i.e. the number of rows and, per column, the number of values, the smallest
+ * and largest value and the number of distinct values (see
+ * ColumnStatistics). These statistics are to be used during optimisation.
+ *
+ * @param range 
+ */
+void Table::updateStatistics(LoadRange &range)
+{
+    this->rowCount += range.rowCount;
+    for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
+        this->columnStatistics[columnCounter].merge(range.columnStatistics[columnCounter]);
+    range.columnStatistics.clear();
+}
+
+/**
+ * @brief Called once all rows have been added to the column statistics. Fills
+ * distinctValuesPerColumnCount and frees the memory only needed while rows
+ * were being added.
  *
- * @param row 
  */
-void Table::updateStatistics(vector<int> row)
+void Table::finishStatistics()
 {
-    this->rowCount++;
+    this->distinctValuesPerColumnCount.assign(this->columnCount, 0);
     for (int columnCounter = 0; columnCounter < this->columnCount; columnCounter++)
     {
-        if (!this->distinctValuesInColumns[columnCounter].count(row[columnCounter]))
-        {
-            this->distinctValuesInColumns[columnCounter].insert(row[columnCounter]);
-            this->distinctValuesPerColumnCount[columnCounter]++;
-        }
+        this->distinctValuesPerColumnCount[columnCounter] = this->columnStatistics[columnCounter].getDistinctCount();
+        this->columnStatistics[columnCounter].releaseExactValues();
     }
 }
 
@@ -208,6 +482,8 @@ void Table::renameColumn(string fromColumnName, string toColumnName)
             break;
         }
     }
+    if (this->sortedColumn == fromColumnName)
+        this->sortedColumn = toColumnName;
     return;
 }
 
@@ -225,7 +501,7 @@ void Table::print()
     //print headings
     this->writeRow(this->columns, cout);
 
-    Cursor cursor(this->tableName, 0);
+    Cursor cursor(this, 0);
     vector<int> row;
     for (int rowCounter = 0; rowCounter < count; rowCounter++)
     {
@@ -264,21 +540,21 @@ void Table::getNextPage(Cursor *cursor)
 void Table::makePermanent()
 {
     logger.log("Table::makePermanent");
+    bufferManager.flushTable(this->tableName);
     if(!this->isPermanent())
         bufferManager.deleteFile(this->sourceFileName);
     string newSourceFile = "../data/" + this->tableName + ".csv";
     ofstream fout(newSourceFile, ios::out);
+    ioStatistics.recordFileOpen(this->tableName);
 
     //print headings
     this->writeRow(this->columns, fout);
 
-    Cursor cursor(this->tableName, 0);
-    vector<int> row;
-    for (int rowCounter = 0; rowCounter < this->rowCount; rowCounter++)
-    {
-        row = cursor.getNext();
-        this->writeRow(row, fout);
-    }
+    Cursor cursor(this, 0);
+    RowBatch batch;
+    while (cursor.getNextBatch(batch, this->maxRowsPerBlock))
+        for (int rowCounter = 0; rowCounter < batch.rowCount; rowCounter++)
+            this->writeRow(batch.getRow(rowCounter), fout);
     fout.close();
 }
 
@@ -305,6 +581,7 @@ void Table::unload(){
     logger.log("Table::~unload");
     for (int pageCounter = 0; pageCounter < this->blockCount; pageCounter++)
         bufferManager.deleteFile(this->tableName, pageCounter);
+    segmentManager.deleteSegment(this->tableName);
     if (!isPermanent())
         bufferManager.deleteFile(this->sourceFileName);
 }
@@ -317,7 +594,7 @@ void Table::unload(){
 Cursor Table::getCursor()
 {
     logger.log("Table::getCursor");
-    Cursor cursor(this->tableName, 0);
+    Cursor cursor(this, 0);
     return cursor;
 }
 /**
@@ -335,3 +612,20 @@ int Table::getColumnIndex(string columnName)
             return columnCounter;
     }
 }
+
+/**
+ * @brief Parses a block size in KB as typed by the user.
+ *
+ * @param text 
+ * @param blockSize set when the text is a valid block size
+ * @return true if text is a positive number
+ * @return false otherwise
+ */
+bool parseBlockSize(string text, float &blockSize)
+{
+    if (text.empty() || text.size() > 8 || text.find_first_not_of("0123456789.") != string::npos ||
+        count(text.begin(), text.end(), '.') > 1 || text == ".")
+        return false;
+    blockSize = stof(text);
+    return blockSize > 0;
+}
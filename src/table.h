@@ -1,6 +1,10 @@
 #ifndef TABLE_H
 #define TABLE_H
 #include "cursor.h"
+#include "csvReader.h"
+#include "columnStatistics.h"
+
+extern float BLOCK_SIZE;
 
 enum IndexingStrategy
 {
@@ -9,6 +13,33 @@ enum IndexingStrategy
     NOTHING
 };
 
+/**
+ * @brief A byte range of a CSV file that one LOAD worker turns into pages.
+ * The range starts at the beginning of a line and holds rowCount rows, the
+ * first of which is row firstRow of the table. Pages that lie completely
+ * inside the range are written by the worker itself; the rows of pages shared
+ * with neighbouring ranges are handed back in headCells and tailCells so the
+ * loader can assemble those pages once every worker is done. The zone maps of
+ * the pages the worker wrote, in page order, are kept in zoneMinValues and
+ * zoneMaxValues.
+ *
+ */
+struct LoadRange
+{
+    off_t beginOffset = 0;
+    off_t endOffset = 0;
+    long long firstRow = 0;
+    long long rowCount = 0;
+    vector<int> headCells;
+    long long tailFirstRow = 0;
+    vector<int> tailCells;
+    vector<ColumnStatistics> columnStatistics;
+    vector<int> zoneMinValues;
+    vector<int> zoneMaxValues;
+    bool failed = false;
+    exception_ptr error;
+};
+
 /**
  * @brief The Table class holds all information related to a loaded table. It
  * also implements methods that interact with the parsers, executors, cursors
@@ -17,30 +48,54 @@ enum IndexingStrategy
  * command and the second is to use assignment statements (SELECT, PROJECT,
  * JOIN, SORT, CROSS and DISTINCT). 
  *
+ * <p>
+ * Every page also has a zone map: the smallest and largest value of each
+ * column within the page, recorded when the page is written, so operators can
+ * skip pages that cannot hold a matching row without reading them.
+ * </p>
+ *
+ * <p>
+ * A table written by SORT remembers the column its rows are sorted on, so
+ * operators that need the rows in that order can read them as they are.
+ * </p>
+ *
  */
 class Table
 {
-    vector<unordered_set<int>> distinctValuesInColumns;
-
 public:
     string sourceFileName = "";
     string tableName = "";
     vector<string> columns;
     vector<uint> distinctValuesPerColumnCount;
+    vector<ColumnStatistics> columnStatistics;
     uint columnCount = 0;
     long long int rowCount = 0;
     uint blockCount = 0;
     uint maxRowsPerBlock = 0;
+    float blockSize = BLOCK_SIZE;
     vector<uint> rowsPerBlockCount;
+    vector<int> pageMinValues;
+    vector<int> pageMaxValues;
     bool indexed = false;
     string indexedColumn = "";
     IndexingStrategy indexingStrategy = NOTHING;
+    string sortedColumn = "";
+    bool sortedDescending = false;
     
+    static const size_t MIN_LOAD_RANGE_BYTES = 4 << 20;
+
     bool extractColumnNames(string firstLine);
     bool blockify();
-    void updateStatistics(vector<int> row);
+    vector<LoadRange> splitSourceFile(off_t fileSize, int rangeCount);
+    void countRows(LoadRange &range);
+    void blockifyRange(LoadRange &range);
+    void updateStatistics(LoadRange &range);
+    void finishStatistics();
+    size_t getPageSize();
+    bool getPageValueRange(int pageIndex, int columnIndex, int &minValue, int &maxValue);
     Table();
     Table(string tableName);
+    Table(string tableName, float blockSize);
     Table(string tableName, vector<string> columns);
     bool load();
     bool isColumn(string columnName);
@@ -74,19 +129,24 @@ void writeRow(vector<T> row, ostream &fout)
 }
 
 /**
- * @brief Static function that takes a vector of valued and prints them out in a
- * comma seperated format.
+ * @brief Prints a row viewed inside a page in a comma seperated format.
  *
- * @tparam T current usaages include int and string
  * @param row 
+ * @param fout 
  */
-template <typename T>
-void writeRow(vector<T> row)
+void writeRow(const RowView &row, ostream &fout)
 {
     logger.log("Table::printRow");
-    ofstream fout(this->sourceFileName, ios::app);
-    this->writeRow(row, fout);
-    fout.close();
+    for (int columnCounter = 0; columnCounter < row.size(); columnCounter++)
+    {
+        if (columnCounter != 0)
+            fout << ", ";
+        fout << row[columnCounter];
+    }
+    fout << endl;
 }
 };
+
+bool parseBlockSize(string text, float &blockSize);
+void computeZoneMap(const int *cells, int rowCount, int columnCount, int *minValues, int *maxValues);
 #endif
\ No newline at end of file
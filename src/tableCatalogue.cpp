@@ -20,8 +20,10 @@ void TableCatalogue::removeTable(string tableName)
 Table* TableCatalogue::getTable(string tableName)
 {
     logger.log("TableCatalogue::getTable"); 
-    Table *table = this->tables[tableName];
-    return table;
+    auto table = this->tables.find(tableName);
+    if (table == this->tables.end())
+        return nullptr;
+    return table->second;
 }
 bool TableCatalogue::isTable(string tableName)
 {
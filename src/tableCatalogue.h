@@ -1,6 +1,6 @@
 #ifndef TABLECATALOGUE_H
 #define TABLECATALOGUE_H
-#include "table.h"
+#include "tableWriter.h"
 
 /**
  * @brief The TableCatalogue acts like an index of tables existing in the
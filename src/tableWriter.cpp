@@ -0,0 +1,89 @@
+#include "global.h"
+
+/**
+ * @brief Construct a new TableWriter:: TableWriter object for a table that has
+ * been created with its columns but holds no pages yet.
+ *
+ * @param table 
+ * @param gatherStatistics whether column statistics are kept for the table
+ */
+TableWriter::TableWriter(Table *table, bool gatherStatistics)
+{
+    logger.log("TableWriter::TableWriter");
+    this->table = table;
+    this->gatherStatistics = gatherStatistics;
+    this->rowsInPage.assign((size_t)table->maxRowsPerBlock * table->columnCount, 0);
+    table->columnStatistics.assign(table->columnCount, ColumnStatistics());
+    if (!TEXT_PAGES)
+        segmentManager.createSegment(table->tableName, table->getPageSize());
+}
+
+/**
+ * @brief Appends one row of columnCount values to the table.
+ *
+ * @param row 
+ */
+void TableWriter::writeRow(const int *row)
+{
+    int columnCount = this->table->columnCount;
+    copy(row, row + columnCount, this->rowsInPage.begin() + (size_t)this->pageCounter * columnCount);
+    if (this->gatherStatistics)
+        for (int columnCounter = 0; columnCounter < columnCount; columnCounter++)
+            this->table->columnStatistics[columnCounter].add(row[columnCounter]);
+    this->table->rowCount++;
+    if (++this->pageCounter == this->table->maxRowsPerBlock)
+        this->flushPage();
+}
+
+void TableWriter::writeRow(const RowView &row)
+{
+    this->writeRow(row.begin());
+}
+
+/**
+ * @brief Appends all rows of the batch to the table.
+ *
+ * @param batch 
+ */
+void TableWriter::writeRows(const RowBatch &batch)
+{
+    for (int rowCounter = 0; rowCounter < batch.rowCount; rowCounter++)
+        this->writeRow(batch.cells + (size_t)rowCounter * batch.columnCount);
+}
+
+/**
+ * @brief Writes the rows collected so far as the next page of the table and
+ * records its zone map.
+ *
+ */
+void TableWriter::flushPage()
+{
+    if (!this->pageCounter)
+        return;
+    logger.log("TableWriter::flushPage");
+    Table *table = this->table;
+    size_t firstZone = table->pageMinValues.size();
+    table->pageMinValues.resize(firstZone + table->columnCount);
+    table->pageMaxValues.resize(firstZone + table->columnCount);
+    computeZoneMap(this->rowsInPage.data(), this->pageCounter, table->columnCount,
+                   &table->pageMinValues[firstZone], &table->pageMaxValues[firstZone]);
+    bufferManager.writePage(table->tableName, table->blockCount, this->rowsInPage, this->pageCounter, table->columnCount);
+    table->blockCount++;
+    table->rowsPerBlockCount.emplace_back(this->pageCounter);
+    this->pageCounter = 0;
+}
+
+/**
+ * @brief Writes the last, partially filled page and completes the table's
+ * statistics.
+ *
+ * @return true if at least one row was written
+ * @return false if the table is empty
+ */
+bool TableWriter::close()
+{
+    logger.log("TableWriter::close");
+    this->flushPage();
+    this->table->finishStatistics();
+    return this->table->rowCount != 0;
+}
@@ -0,0 +1,33 @@
+#ifndef TABLEWRITER_H
+#define TABLEWRITER_H
+#include "table.h"
+
+/**
+ * @brief A TableWriter fills the pages of a result table directly. Rows are
+ * copied into the buffer of the page being filled and every full page is
+ * handed to the buffer manager, so writing a result costs one page write per
+ * page instead of a CSV line per row that blockify would have to parse again.
+ * The table's row count, column statistics, zone maps and rowsPerBlockCount
+ * are kept up to date as rows are written; close must be called once the last
+ * row has been written. Column statistics can be left out for temporary
+ * tables that no query plans against.
+ *
+ */
+class TableWriter
+{
+    Table *table;
+    vector<int> rowsInPage;
+    int pageCounter = 0;
+    bool gatherStatistics;
+
+    void flushPage();
+
+public:
+    TableWriter(Table *table, bool gatherStatistics = true);
+    void writeRow(const int *row);
+    void writeRow(const RowView &row);
+    void writeRows(const RowBatch &batch);
+    bool close();
+};
+
+#endif
@@ -0,0 +1,294 @@
+//Buffer pool stress test
+#include "global.h"
+
+using namespace std;
+
+float BLOCK_SIZE = 0.25;
+uint BLOCK_COUNT = 2;
+size_t BUFFER_BYTES = 2000;
+uint PRINT_COUNT = 20;
+uint PREFETCH_DEPTH = 4;
+uint WORKER_COUNT = max(1u, thread::hardware_concurrency());
+uint EXACT_DISTINCT_LIMIT = 1 << 16;
+bool TEXT_PAGES = false;
+bool MMAP_PAGES = false;
+Logger logger;
+IOStatistics ioStatistics;
+vector<string> tokenizedQuery;
+ParsedQuery parsedQuery;
+SegmentManager segmentManager;
+BufferManager bufferManager;
+TableCatalogue tableCatalogue;
+GraphCatalogue graphCatalogue;
+
+static const int TABLE_COUNT = 3;
+static const int COLUMN_COUNT = 4;
+static const int MAX_HELD_HANDLES = 4;
+static const int MAX_SCAN_LENGTH = 8;
+
+struct StressOptions
+{
+    int shardCount = 1;
+    int threadCount = 8;
+    int iterationCount = 5000;
+    int pageCount = 1500;
+};
+
+vector<Table *> tables;
+atomic<long long> checkedPageCount{0};
+atomic<int> failureCount{0};
+mutex failureMutex;
+string firstFailure;
+
+/**
+ * @brief The value every cell of the test tables holds, so the contents of a
+ * page can be checked without keeping a copy of the table.
+ *
+ * @param tableIndex
+ * @param rowIndex
+ * @param columnIndex
+ * @return int
+ */
+static int getCellValue(int tableIndex, long long rowIndex, int columnIndex)
+{
+    return (int)((tableIndex * 1000003LL + rowIndex * COLUMN_COUNT + columnIndex) & 0x7fffffff);
+}
+
+static void recordFailure(string failure)
+{
+    lock_guard<mutex> lock(failureMutex);
+    if (failureCount++ == 0)
+        firstFailure = failure;
+}
+
+/**
+ * @brief Creates the test tables with a TableWriter and writes all their
+ * pages to disk, so that every later read of an evicted page goes to the
+ * segment.
+ *
+ * @param options
+ */
+static void createTables(const StressOptions &options)
+{
+    logger.log("createTables");
+    vector<string> columns = {"a", "b", "c", "d"};
+    for (int tableIndex = 0; tableIndex < TABLE_COUNT; tableIndex++)
+    {
+        Table *table = new Table("#stress" + to_string(tableIndex), columns);
+        TableWriter writer(table, false);
+        long long rowCount = (long long)options.pageCount * table->maxRowsPerBlock;
+        int row[COLUMN_COUNT];
+        for (long long rowIndex = 0; rowIndex < rowCount; rowIndex++)
+        {
+            for (int columnIndex = 0; columnIndex < COLUMN_COUNT; columnIndex++)
+                row[columnIndex] = getCellValue(tableIndex, rowIndex, columnIndex);
+            writer.writeRow(row);
+        }
+        writer.close();
+        tableCatalogue.insertTable(table);
+        bufferManager.flushTable(table->tableName);
+        tables.push_back(table);
+    }
+}
+
+/**
+ * @brief Checks that a pinned page holds exactly the rows of the page it was
+ * pinned as.
+ *
+ * @param page
+ * @param tableIndex
+ * @param pageIndex
+ */
+static void checkPage(const PageHandle &page, int tableIndex, int pageIndex)
+{
+    Table *table = tables[tableIndex];
+    string pageName = table->tableName + "[" + to_string(pageIndex) + "]";
+    checkedPageCount++;
+    if (!page.isValid())
+    {
+        recordFailure(pageName + ": invalid handle");
+        return;
+    }
+    if (page->getRowCount() != (int)table->rowsPerBlockCount[pageIndex] || page->getColumnCount() != COLUMN_COUNT)
+    {
+        recordFailure(pageName + ": " + to_string(page->getRowCount()) + " rows of " +
+                      to_string(page->getColumnCount()) + " columns");
+        return;
+    }
+    long long firstRow = (long long)pageIndex * table->maxRowsPerBlock;
+    for (int rowCounter = 0; rowCounter < page->getRowCount(); rowCounter++)
+    {
+        RowView row = page->getRow(rowCounter);
+        for (int columnIndex = 0; columnIndex < COLUMN_COUNT; columnIndex++)
+            if (row[columnIndex] != getCellValue(tableIndex, firstRow + rowCounter, columnIndex))
+            {
+                recordFailure(pageName + ": wrong value in row " + to_string(rowCounter) + " column " + to_string(columnIndex));
+                return;
+            }
+    }
+}
+
+/**
+ * @brief Body of a test thread. Every iteration either pins a random page and
+ * keeps the handle for a while, scans a few pages sequentially under the
+ * thread's stream id so the pool reads ahead, copies a handle that is held
+ * or lets one go. Random pins of pages that another thread's scan has queued
+ * for read-ahead cancel those prefetches.
+ *
+ * @param threadIndex
+ * @param options
+ */
+static void stressPool(int threadIndex, const StressOptions &options)
+{
+    mt19937 generator(7919 * (threadIndex + 1));
+    int streamId = 1000000 + threadIndex;
+    vector<PageHandle> handles;
+    vector<pair<int, int>> heldPages;
+    for (int iteration = 0; iteration < options.iterationCount && failureCount == 0; iteration++)
+    {
+        int tableIndex = generator() % TABLE_COUNT;
+        Table *table = tables[tableIndex];
+        int pageIndex = generator() % table->blockCount;
+        switch (generator() % 4)
+        {
+        case 0:
+        {
+            PageHandle page = bufferManager.pinPage(table, pageIndex);
+            checkPage(page, tableIndex, pageIndex);
+            if (handles.size() < MAX_HELD_HANDLES)
+            {
+                handles.push_back(move(page));
+                heldPages.push_back({tableIndex, pageIndex});
+            }
+            else
+            {
+                int slot = generator() % handles.size();
+                handles[slot] = page;
+                heldPages[slot] = {tableIndex, pageIndex};
+            }
+            break;
+        }
+        case 1:
+        {
+            int lastPage = min<int>(table->blockCount - 1, pageIndex + 1 + generator() % MAX_SCAN_LENGTH);
+            PageHandle page;
+            for (; pageIndex <= lastPage; pageIndex++)
+            {
+                page = bufferManager.pinPage(table, pageIndex, streamId);
+                checkPage(page, tableIndex, pageIndex);
+            }
+            break;
+        }
+        case 2:
+        {
+            if (handles.empty())
+                break;
+            int slot = generator() % handles.size();
+            PageHandle copied(handles[slot]);
+            checkPage(copied, heldPages[slot].first, heldPages[slot].second);
+            PageHandle assigned;
+            assigned = copied;
+            copied.release();
+            checkPage(assigned, heldPages[slot].first, heldPages[slot].second);
+            break;
+        }
+        default:
+        {
+            if (handles.empty())
+                break;
+            int slot = generator() % handles.size();
+            handles[slot].release();
+            handles.erase(handles.begin() + slot);
+            heldPages.erase(heldPages.begin() + slot);
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * @brief Reads the options. Supported options are --shards=N to choose how
+ * many shards the pool is split into (1 to MAX_SHARD_COUNT), --threads=N,
+ * --iterations=N per thread, --pages=N per table and --mmap to read pages
+ * through memory mappings.
+ *
+ * @param argc
+ * @param argv
+ * @param options
+ * @return true if all options were understood
+ * @return false otherwise
+ */
+bool parseOptions(int argc, char *argv[], StressOptions &options)
+{
+    for (int argCounter = 1; argCounter < argc; argCounter++)
+    {
+        string option = argv[argCounter];
+        size_t separator = option.find('=');
+        string value = separator == string::npos ? "" : option.substr(separator + 1);
+        bool isNumber = !value.empty() && value.size() <= 9 && value.find_first_not_of("0123456789") == string::npos;
+        int number = isNumber ? stoi(value) : 0;
+        if (option == "--mmap")
+            MMAP_PAGES = true;
+        else if (option.rfind("--shards=", 0) == 0 && number >= 1 && number <= BufferManager::MAX_SHARD_COUNT)
+            options.shardCount = number;
+        else if (option.rfind("--threads=", 0) == 0 && number >= 1)
+            options.threadCount = number;
+        else if (option.rfind("--iterations=", 0) == 0 && isNumber)
+            options.iterationCount = number;
+        else if (option.rfind("--pages=", 0) == 0 && number >= 1)
+            options.pageCount = number;
+        else
+        {
+            cout << "Invalid option: " << option << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    StressOptions options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+    system("mkdir -p ../data/temp");
+
+    // every shard gets MIN_BLOCKS_PER_SHARD blocks, far fewer than the tables have
+    size_t blockBytes = BLOCK_SIZE * 1000;
+    bufferManager.setBufferBytes((size_t)options.shardCount * BufferManager::MIN_BLOCKS_PER_SHARD * blockBytes);
+    if (bufferManager.getPoolShardCount() != options.shardCount)
+    {
+        cout << "FAILED: pool has " << bufferManager.getPoolShardCount() << " shards instead of " << options.shardCount << endl;
+        return 1;
+    }
+    createTables(options);
+    long long evictionsBefore = bufferManager.evictionCount;
+
+    vector<thread> threads;
+    for (int threadIndex = 0; threadIndex < options.threadCount; threadIndex++)
+        threads.emplace_back(stressPool, threadIndex, cref(options));
+    for (thread &stressThread : threads)
+        stressThread.join();
+
+    string problem;
+    if (failureCount == 0 && bufferManager.getPinnedBytes() != 0)
+        recordFailure(to_string(bufferManager.getPinnedBytes()) + " bytes still pinned");
+    if (failureCount == 0 && !bufferManager.checkFrames(problem))
+        recordFailure(problem);
+    if (failureCount == 0 && bufferManager.evictionCount == evictionsBefore)
+        recordFailure("no page was evicted, the pool is too large to stress");
+
+    cout << "shards=" << options.shardCount << " threads=" << options.threadCount
+         << " pages checked=" << checkedPageCount << " hits=" << bufferManager.hitCount
+         << " misses=" << bufferManager.missCount << " evictions=" << bufferManager.evictionCount
+         << " prefetches=" << bufferManager.prefetchCount << endl;
+    for (Table *table : tables)
+        tableCatalogue.deleteTable(table->tableName);
+    if (failureCount)
+    {
+        cout << "FAILED: " << firstFailure << " (" << failureCount << " failures)" << endl;
+        return 1;
+    }
+    cout << "PASSED" << endl;
+    return 0;
+}